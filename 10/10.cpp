@@ -1,5 +1,9 @@
 #include <iostream>
 #include <vector>
+#include <string>
+#include <algorithm>
+#include <thread>
+#include <smmintrin.h>
 
 // https://adventofcode.com/2018/day/10
 
@@ -23,73 +27,357 @@ void ReadCoordinates(std::vector<Coordinate> &output, std::istream &input)
 	}
 }
 
-void Part1And2(std::vector<Coordinate> const &coordinates)
+// bounding box of the coordinates at a given time
+struct BoundingBox
 {
-	// find the time at which the bounding box is smallest
-	int bestTime = -1;
-	int bestMinX = INT_MAX, bestMaxX = INT_MIN;
-	int bestMinY = INT_MAX, bestMaxY = INT_MIN;
-	int64_t bestArea = INT64_MAX;
-
-	// for each time step
-	int curTime = 0;
-	for (;;)
-	{
-		// find the bounding box of the coordinates
-		int curMinX = INT_MAX, curMaxX = INT_MIN;
-		int curMinY = INT_MAX, curMaxY = INT_MIN;
-		for (Coordinate const &coordinate : coordinates)
+	int minX = INT_MAX, maxX = INT_MIN;
+	int minY = INT_MAX, maxY = INT_MIN;
+
+	// get the area of the bounding box
+	int64_t Area() const
+	{
+		return int64_t(maxX - minX + 1) * int64_t(maxY - minY + 1);
+	}
+};
+
+// coordinates split into one array per component, padded to groups of four for SIMD
+// (padded with copies of the first coordinate, which leave the bounding box unchanged)
+struct CoordinateLanes
+{
+	std::vector<int32_t> positionX;
+	std::vector<int32_t> positionY;
+	std::vector<int32_t> velocityX;
+	std::vector<int32_t> velocityY;
+
+	explicit CoordinateLanes(std::vector<Coordinate> const &coordinates)
+	{
+		size_t count = (coordinates.size() + 3) & ~size_t(3);
+		positionX.resize(count);
+		positionY.resize(count);
+		velocityX.resize(count);
+		velocityY.resize(count);
+		for (size_t index = 0; index < count; ++index)
 		{
-			int x = coordinate.positionX + curTime * coordinate.velocityX;
-			int y = coordinate.positionY + curTime * coordinate.velocityY;
-			if (curMinX > x)
-				curMinX = x;
-			if (curMaxX < x)
-				curMaxX = x;
-			if (curMinY > y)
-				curMinY = y;
-			if (curMaxY < y)
-				curMaxY = y;
+			Coordinate const &c = coordinates[index < coordinates.size() ? index : 0];
+			positionX[index] = c.positionX;
+			positionY[index] = c.positionY;
+			velocityX[index] = c.velocityX;
+			velocityY[index] = c.velocityY;
 		}
+	}
+
+	// number of groups of four coordinates
+	size_t GroupCount() const
+	{
+		return positionX.size() / 4;
+	}
+};
+
+// get the smallest of the four lanes
+int ReduceMin(__m128i value)
+{
+	value = _mm_min_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2)));
+	value = _mm_min_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(value);
+}
+
+// get the largest of the four lanes
+int ReduceMax(__m128i value)
+{
+	value = _mm_max_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2)));
+	value = _mm_max_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(value);
+}
+
+// find the bounding box of a range of coordinate groups at a given time
+BoundingBox GetBoundingBox(CoordinateLanes const &lanes, int time, size_t firstGroup, size_t lastGroup)
+{
+	const __m128i t = _mm_set1_epi32(time);
+	__m128i minX = _mm_set1_epi32(INT_MAX), maxX = _mm_set1_epi32(INT_MIN);
+	__m128i minY = _mm_set1_epi32(INT_MAX), maxY = _mm_set1_epi32(INT_MIN);
+	for (size_t group = firstGroup; group < lastGroup; ++group)
+	{
+		size_t index = group * 4;
+		__m128i x = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const *>(&lanes.positionX[index])), _mm_mullo_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const *>(&lanes.velocityX[index])), t));
+		__m128i y = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const *>(&lanes.positionY[index])), _mm_mullo_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const *>(&lanes.velocityY[index])), t));
+		minX = _mm_min_epi32(minX, x);
+		maxX = _mm_max_epi32(maxX, x);
+		minY = _mm_min_epi32(minY, y);
+		maxY = _mm_max_epi32(maxY, y);
+	}
+
+	BoundingBox box;
+	box.minX = ReduceMin(minX);
+	box.maxX = ReduceMax(maxX);
+	box.minY = ReduceMin(minY);
+	box.maxY = ReduceMax(maxY);
+	return box;
+}
 
-		// get the area of the bounding box
-		int64_t curArea = int64_t(curMaxX - curMinX + 1) * int64_t(curMaxY - curMinY + 1);
+// find the bounding box of the coordinates at a given time
+// (large fields are split across threads)
+BoundingBox GetBoundingBox(CoordinateLanes const &lanes, int time)
+{
+	const size_t minGroupsPerThread = 1 << 16;
+	const size_t groupCount = lanes.GroupCount();
+	size_t threadCount = std::min<size_t>(std::max(1U, std::thread::hardware_concurrency()), (groupCount + minGroupsPerThread - 1) / minGroupsPerThread);
+	if (threadCount <= 1)
+		return GetBoundingBox(lanes, time, 0, groupCount);
 
-		// update the best time
-		if (bestArea > curArea)
+	// each thread handles one slice of the groups
+	std::vector<BoundingBox> boxes(threadCount);
+	std::vector<std::thread> threads;
+	for (size_t slice = 1; slice < threadCount; ++slice)
+	{
+		threads.emplace_back([&lanes, &boxes, time, slice, threadCount, groupCount]()
 		{
-			bestTime = curTime;
-			bestMinX = curMinX;
-			bestMaxX = curMaxX;
-			bestMinY = curMinY;
-			bestMaxY = curMaxY;
-			bestArea = curArea;
+			boxes[slice] = GetBoundingBox(lanes, time, groupCount * slice / threadCount, groupCount * (slice + 1) / threadCount);
+		});
+	}
+	boxes[0] = GetBoundingBox(lanes, time, 0, groupCount / threadCount);
+	for (std::thread &thread : threads)
+	{
+		thread.join();
+	}
+
+	// combine the slices
+	BoundingBox box = boxes[0];
+	for (BoundingBox const &slice : boxes)
+	{
+		box.minX = std::min(box.minX, slice.minX);
+		box.maxX = std::max(box.maxX, slice.maxX);
+		box.minY = std::min(box.minY, slice.minY);
+		box.maxY = std::max(box.maxY, slice.maxY);
+	}
+	return box;
+}
+
+// estimate when the coordinates converge
+// (the time at which the points with the lowest and highest velocities line up)
+int EstimateTime(std::vector<Coordinate> const &coordinates)
+{
+	Coordinate const *slowestX = &coordinates[0], *fastestX = &coordinates[0];
+	Coordinate const *slowestY = &coordinates[0], *fastestY = &coordinates[0];
+	for (Coordinate const &coordinate : coordinates)
+	{
+		if (slowestX->velocityX > coordinate.velocityX)
+			slowestX = &coordinate;
+		if (fastestX->velocityX < coordinate.velocityX)
+			fastestX = &coordinate;
+		if (slowestY->velocityY > coordinate.velocityY)
+			slowestY = &coordinate;
+		if (fastestY->velocityY < coordinate.velocityY)
+			fastestY = &coordinate;
+	}
+
+	// use whichever axis has the larger velocity spread
+	int spreadX = fastestX->velocityX - slowestX->velocityX;
+	int spreadY = fastestY->velocityY - slowestY->velocityY;
+	if (spreadX == 0 && spreadY == 0)
+		return 0;
+	if (spreadX >= spreadY)
+		return std::max(0, (slowestX->positionX - fastestX->positionX) / spreadX);
+	else
+		return std::max(0, (slowestY->positionY - fastestY->positionY) / spreadY);
+}
+
+// 1-bit-per-pixel image with each row packed into 64-bit words
+// (bit 0 of a row's first word is its leftmost pixel)
+struct Bitmap
+{
+	int width;
+	int height;
+	int wordsPerRow;
+	std::vector<uint64_t> words;
+
+	Bitmap(int width, int height)
+		: width(width)
+		, height(height)
+		, wordsPerRow((width + 63) / 64)
+		, words(size_t(wordsPerRow) * height, 0)
+	{
+	}
+
+	void Set(int x, int y)
+	{
+		words[y * wordsPerRow + x / 64] |= uint64_t(1) << (x % 64);
+	}
+
+	bool Get(int x, int y) const
+	{
+		return (words[y * wordsPerRow + x / 64] >> (x % 64)) & 1;
+	}
+
+	// get <count> (up to 64) pixels of a row starting at x as the low bits of the result
+	uint64_t GetBits(int x, int y, int count) const
+	{
+		uint64_t const *row = &words[y * wordsPerRow];
+		int shift = x % 64;
+		uint64_t bits = row[x / 64] >> shift;
+		if (shift != 0 && x / 64 + 1 < wordsPerRow)
+			bits |= row[x / 64 + 1] << (64 - shift);
+		return count < 64 ? bits & ((uint64_t(1) << count) - 1) : bits;
+	}
+};
+
+// glyphs are 6 pixels wide and 10 pixels tall with 2 blank columns between them
+const int GLYPH_WIDTH = 6;
+const int GLYPH_HEIGHT = 10;
+const int GLYPH_SPACING = 8;
+
+// letters known to appear in messages
+struct GlyphArt
+{
+	char letter;
+	char const *rows[GLYPH_HEIGHT];
+};
+const GlyphArt GLYPH_ART[] =
+{
+	{ 'A', { "..##..", ".#..#.", "#....#", "#....#", "#....#", "######", "#....#", "#....#", "#....#", "#....#" } },
+	{ 'B', { "#####.", "#....#", "#....#", "#....#", "#####.", "#....#", "#....#", "#....#", "#....#", "#####." } },
+	{ 'C', { ".####.", "#....#", "#.....", "#.....", "#.....", "#.....", "#.....", "#.....", "#....#", ".####." } },
+	{ 'E', { "######", "#.....", "#.....", "#.....", "#####.", "#.....", "#.....", "#.....", "#.....", "######" } },
+	{ 'F', { "######", "#.....", "#.....", "#.....", "#####.", "#.....", "#.....", "#.....", "#.....", "#....." } },
+	{ 'G', { ".####.", "#....#", "#.....", "#.....", "#.....", "#..###", "#....#", "#....#", "#...##", ".###.#" } },
+	{ 'H', { "#....#", "#....#", "#....#", "#....#", "######", "#....#", "#....#", "#....#", "#....#", "#....#" } },
+	{ 'J', { "...###", "....#.", "....#.", "....#.", "....#.", "....#.", "....#.", "#...#.", "#...#.", ".###.." } },
+	{ 'K', { "#....#", "#...#.", "#..#..", "#.#...", "##....", "##....", "#.#...", "#..#..", "#...#.", "#....#" } },
+	{ 'L', { "#.....", "#.....", "#.....", "#.....", "#.....", "#.....", "#.....", "#.....", "#.....", "######" } },
+	{ 'N', { "#....#", "##...#", "##...#", "#.#..#", "#.#..#", "#..#.#", "#..#.#", "#...##", "#...##", "#....#" } },
+	{ 'P', { "#####.", "#....#", "#....#", "#....#", "#####.", "#.....", "#.....", "#.....", "#.....", "#....." } },
+	{ 'R', { "#####.", "#....#", "#....#", "#....#", "#####.", "#..#..", "#...#.", "#...#.", "#....#", "#....#" } },
+	{ 'X', { "#....#", "#....#", ".#..#.", ".#..#.", "..##..", "..##..", ".#..#.", ".#..#.", "#....#", "#....#" } },
+	{ 'Z', { "######", ".....#", ".....#", "....#.", "...#..", "..#...", ".#....", "#.....", "#.....", "######" } },
+};
+
+// pack a glyph into a 60-bit mask, 6 bits per row with the top row in the low bits
+uint64_t GetGlyphMask(GlyphArt const &art)
+{
+	uint64_t mask = 0;
+	for (int y = 0; y < GLYPH_HEIGHT; ++y)
+	{
+		for (int x = 0; x < GLYPH_WIDTH; ++x)
+		{
+			if (art.rows[y][x] == '#')
+				mask |= uint64_t(1) << (y * GLYPH_WIDTH + x);
 		}
-		else
+	}
+	return mask;
+}
+
+// decode the letters in a message
+// (unrecognized glyphs decode as '?')
+std::string DecodeMessage(Bitmap const &message)
+{
+	if (message.height != GLYPH_HEIGHT)
+		return "?";
+
+	// build the glyph masks
+	uint64_t glyphMasks[sizeof(GLYPH_ART) / sizeof(GLYPH_ART[0])];
+	for (size_t i = 0; i < sizeof(GLYPH_ART) / sizeof(GLYPH_ART[0]); ++i)
+	{
+		glyphMasks[i] = GetGlyphMask(GLYPH_ART[i]);
+	}
+
+	std::string text;
+	for (int cellX = 0; cellX < message.width; cellX += GLYPH_SPACING)
+	{
+		// pack the cell the same way as the glyphs
+		uint64_t mask = 0;
+		for (int y = 0; y < GLYPH_HEIGHT; ++y)
 		{
-			break;
+			mask |= message.GetBits(cellX, y, GLYPH_WIDTH) << (y * GLYPH_WIDTH);
 		}
 
-		++curTime;
+		// find the matching glyph
+		char letter = '?';
+		for (size_t i = 0; i < sizeof(GLYPH_ART) / sizeof(GLYPH_ART[0]); ++i)
+		{
+			if (glyphMasks[i] == mask)
+			{
+				letter = GLYPH_ART[i].letter;
+				break;
+			}
+		}
+		text.push_back(letter);
+	}
+	return text;
+}
+
+// print a bitmap as text
+void PrintBitmap(Bitmap const &bitmap)
+{
+	std::string output;
+	output.reserve(size_t(bitmap.width + 1) * bitmap.height);
+	for (int y = 0; y < bitmap.height; ++y)
+	{
+		for (int x = 0; x < bitmap.width; ++x)
+		{
+			output.push_back(bitmap.Get(x, y) ? '#' : ' ');
+		}
+		output.push_back('\n');
+	}
+	std::cout << output;
+}
+
+void Part1And2(std::vector<Coordinate> const &coordinates)
+{
+	CoordinateLanes lanes(coordinates);
+
+	// the area of the bounding box shrinks until the points converge and then grows,
+	// so start with a window around the estimated time...
+	int estimate = EstimateTime(coordinates);
+	int margin = std::max(16, estimate / 64);
+	int lowTime = std::max(0, estimate - margin);
+	int highTime = estimate + margin;
+
+	// ...widen it until the area is shrinking at the low end and growing at the high end...
+	while (lowTime > 0 && GetBoundingBox(lanes, lowTime).Area() <= GetBoundingBox(lanes, lowTime + 1).Area())
+	{
+		margin *= 2;
+		lowTime = std::max(0, lowTime - margin);
+	}
+	while (GetBoundingBox(lanes, highTime).Area() < GetBoundingBox(lanes, highTime - 1).Area())
+	{
+		margin *= 2;
+		highTime += margin;
 	}
 
-	// build the message output
-	int outputWidth = (bestMaxX - bestMinX + 2);
-	int outputHeight = (bestMaxY - bestMinY + 1);
-	std::string output(outputWidth * outputHeight, ' ');
-	for (int y = bestMinY; y <= bestMaxY; ++y)
+	// ...then ternary search for the smallest area
+	while (highTime - lowTime > 2)
 	{
-		output[(y - bestMinY) * outputWidth + outputWidth - 1] = '\n';
+		int time1 = lowTime + (highTime - lowTime) / 3;
+		int time2 = highTime - (highTime - lowTime) / 3;
+		if (GetBoundingBox(lanes, time1).Area() > GetBoundingBox(lanes, time2).Area())
+			lowTime = time1 + 1;
+		else
+			highTime = time2;
 	}
+
+	// find the time at which the bounding box is smallest
+	int bestTime = lowTime;
+	BoundingBox best = GetBoundingBox(lanes, bestTime);
+	for (int curTime = lowTime + 1; curTime <= highTime; ++curTime)
+	{
+		BoundingBox cur = GetBoundingBox(lanes, curTime);
+		if (best.Area() > cur.Area())
+		{
+			bestTime = curTime;
+			best = cur;
+		}
+	}
+
+	// rasterize the message
+	Bitmap message(best.maxX - best.minX + 1, best.maxY - best.minY + 1);
 	for (Coordinate const &coordinate : coordinates)
 	{
 		int x = coordinate.positionX + bestTime * coordinate.velocityX;
 		int y = coordinate.positionY + bestTime * coordinate.velocityY;
-		output[(y - bestMinY) * outputWidth + (x - bestMinX)] = '#';
+		message.Set(x - best.minX, y - best.minY);
 	}
 
-	std::cout << "Part 1: message is...\n";
-	std::cout << output.c_str();
+	std::cout << "Part 1: message is " << DecodeMessage(message) << "\n";
+	PrintBitmap(message);
 
 	std::cout << "Part 2: time is " << bestTime << "\n";
 }
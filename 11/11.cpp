@@ -1,38 +1,126 @@
 #include <iostream>
+#include <vector>
 #include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <smmintrin.h>
 
 // https://adventofcode.com/2018/day/11
 
+// evaluate every serial (and optional grid size) listed in the input concurrently
+//#define BATCH
+
+// time each kernel repeatedly across a range of grid sizes
+//#define BENCHMARK
+
+// find the best square of each size on a grid too large to hold in memory
+//#define STREAMING
+#ifdef STREAMING
+const int STREAMING_GRID_SIZE = 100000;
+const int STREAMING_MAX_SIZE = 3;
+#endif
+
+// width and height of the fuel cell grid
+const int DEFAULT_GRID_SIZE = 300;
+
+// square grid of values stored on the heap
+template <typename T>
+struct Grid
+{
+	int size;
+	std::vector<T> values;
+
+	explicit Grid(int size = 0)
+	{
+		Resize(size);
+	}
+
+	// resize the grid and clear all values to zero
+	void Resize(int newSize)
+	{
+		size = newSize;
+		values.assign(size_t(size) * size, T(0));
+	}
+
+	// get a row of the grid
+	T *operator[](int y)
+	{
+		return &values[size_t(y) * size];
+	}
+	T const *operator[](int y) const
+	{
+		return &values[size_t(y) * size];
+	}
+};
+
 int GetPower(int x, int y, int serial)
 {
-	int rackID = x + 10;
-	int power = rackID * y;
+	// use 64-bit math so large grids do not overflow
+	int64_t rackID = x + 10;
+	int64_t power = rackID * y;
 	power += serial;
 	power *= rackID;
 	power /= 100;
 	power %= 10;
 	power -= 5;
-	return power;
+	return int(power);
+}
+
+// power level for each fuel cell
+// (values range from -5 to +4)
+void BuildPowerGrid(Grid<int8_t> &power, int gridSize, int serial)
+{
+	power.Resize(gridSize);
+	for (int y = 0; y < gridSize; ++y)
+	{
+		for (int x = 0; x < gridSize; ++x)
+		{
+			power[y][x] = GetPower(x + 1, y + 1, serial);
+		}
+	}
 }
 
-void GetBestPower(int &bestPower, int &bestX, int &bestY, int8_t const (&power)[300][300], int size)
+// build summed-area table (shifted by 1 in x and y)
+void BuildSummedAreaTable(Grid<int32_t> &summed_area_table, Grid<int8_t> const &power)
+{
+	summed_area_table.Resize(power.size + 1);
+	for (int y = 0; y < power.size; ++y)
+	{
+		for (int x = 0; x < power.size; ++x)
+		{
+			summed_area_table[y + 1][x + 1] = power[y][x];
+			summed_area_table[y + 1][x + 1] += summed_area_table[y][x + 1];
+			summed_area_table[y + 1][x + 1] -= summed_area_table[y][x];
+			summed_area_table[y + 1][x + 1] += summed_area_table[y + 1][x];
+		}
+	}
+}
+
+// (partial is scratch space for the row sums, kept by the caller so repeated calls don't reallocate it)
+void GetBestPower(int &bestPower, int &bestX, int &bestY, Grid<int8_t> const &power, int size, Grid<int32_t> &partial)
 {
 	bestPower = INT_MIN, bestX = INT_MIN, bestY = INT_MIN;
 
+	const int gridSize = power.size;
+
 	// compute partial sums of <size> successive power values along x;
-	// values range from -1500 (-5*300) to 1200 (4*300) so use int16_t instead of int8_t
-	int16_t partial[300][300] = { 0 };
-	for (int y = 0; y < 300; ++y)
+	// values range from -5*<grid size> to 4*<grid size> so use int32_t instead of int8_t
+	// (every entry read below is written first, so the scratch grid doesn't need clearing)
+	if (partial.size != gridSize)
+		partial.Resize(gridSize);
+	for (int y = 0; y < gridSize; ++y)
 	{
 		// sum of the <size> elements from power[y][0] to power[y][size-1]
-		int16_t sum = power[y][0];
+		int32_t sum = power[y][0];
 		for (int x = 1; x < size; ++x)
 		{
 			sum += power[y][x];
 		}
 		partial[y][0] = sum;
 
-		for (int x = 1; x < 300 - size; ++x)
+		for (int x = 1; x < gridSize - size; ++x)
 		{
 			// sum of the <size> elements from power[y][x] to power[y][x+size-1]
 			sum -= power[y][x - 1];
@@ -42,7 +130,7 @@ void GetBestPower(int &bestPower, int &bestX, int &bestY, int8_t const (&power)[
 	}
 
 	// compute sums of <size> successive partial sums along y to get the total power in each <size>x<size> square
-	for (int x = 0; x < 300 - size; ++x)
+	for (int x = 0; x < gridSize - size; ++x)
 	{
 		// sum of the <size> elements from partial[0][x] to partial[size-1][x]
 		int32_t sum = partial[0][x];
@@ -59,7 +147,7 @@ void GetBestPower(int &bestPower, int &bestX, int &bestY, int8_t const (&power)[
 			bestY = 1;
 		}
 
-		for (int y = 1; y < 300 - size; ++y)
+		for (int y = 1; y < gridSize - size; ++y)
 		{
 			// sum of the <size> elements from partial[y][x] to partial[y+size-1][x]
 			sum -= partial[y - 1][x];
@@ -76,26 +164,28 @@ void GetBestPower(int &bestPower, int &bestX, int &bestY, int8_t const (&power)[
 	}
 }
 
-void Part1(int8_t const (&power)[300][300])
+void Part1(Grid<int8_t> const &power)
 {
 	// find the best 3x3 square
 	int bestPower, bestX, bestY;
+	Grid<int32_t> partial;
 	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-	GetBestPower(bestPower, bestX, bestY, power, 3);
+	GetBestPower(bestPower, bestX, bestY, power, 3, partial);
 	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
 	std::cout << "Largest total power " << bestPower << " at (" << bestX << ", " << bestY << ") [" << std::chrono::duration<float>(t2 - t1).count() << "]\n";
 }
 
-void Part2(int8_t const (&power)[300][300])
+void Part2(Grid<int8_t> const &power)
 {
 	// find the best square of any size
 	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
 	int bestPower = INT_MIN, bestX = INT_MIN, bestY = INT_MIN, bestSize = INT_MIN;
-	for (int size = 1; size <= 300; ++size)
+	Grid<int32_t> partial(power.size);
+	for (int size = 1; size <= power.size; ++size)
 	{
 		// find the best <size>x<size> square
 		int curPower, curX, curY;
-		GetBestPower(curPower, curX, curY, power, size);
+		GetBestPower(curPower, curX, curY, power, size, partial);
 		if (bestPower < curPower)
 		{
 			bestPower = curPower;
@@ -108,13 +198,212 @@ void Part2(int8_t const (&power)[300][300])
 	std::cout << "Largest total power " << bestPower << " at (" << bestX << ", " << bestY << ") size " << bestSize << " [" << std::chrono::duration<float>(t2 - t1).count() << "]\n";
 }
 
-void GetBestPowerSAT(int &bestPower, int &bestX, int &bestY, int32_t const (&summed_area_table)[301][301], int size)
+// get the largest of the four lanes
+int ReduceMax(__m128i value)
+{
+	value = _mm_max_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2)));
+	value = _mm_max_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(value);
+}
+
+void GetBestPowerSAT(int &bestPower, int &bestX, int &bestY, Grid<int32_t> const &summed_area_table, int size)
+{
+	bestPower = INT_MIN, bestX = INT_MIN, bestY = INT_MIN;
+
+	const int count = summed_area_table.size - 1 - size;
+	for (int y = 0; y < count; ++y)
+	{
+		int32_t const *top = summed_area_table[y];
+		int32_t const *bottom = summed_area_table[y + size];
+
+		// find the best total power in the row, four squares at a time
+		__m128i best4 = _mm_set1_epi32(INT_MIN);
+		int x = 0;
+		for (; x + 4 <= count; x += 4)
+		{
+			// compute sums over the areas
+			__m128i sum4 = _mm_sub_epi32(
+				_mm_add_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const *>(top + x)), _mm_loadu_si128(reinterpret_cast<__m128i const *>(bottom + x + size))),
+				_mm_add_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const *>(top + x + size)), _mm_loadu_si128(reinterpret_cast<__m128i const *>(bottom + x))));
+			best4 = _mm_max_epi32(best4, sum4);
+		}
+		int rowPower = ReduceMax(best4);
+		for (; x < count; ++x)
+		{
+			int32_t sum = top[x] - top[x + size] + bottom[x + size] - bottom[x];
+			if (rowPower < sum)
+				rowPower = sum;
+		}
+
+		// update the best total power with the first square in the row that has it
+		if (bestPower < rowPower)
+		{
+			for (x = 0; top[x] - top[x + size] + bottom[x + size] - bottom[x] != rowPower; ++x)
+				;
+			bestPower = rowPower;
+			bestX = x + 1;
+			bestY = y + 1;
+		}
+	}
+}
+
+void Part1SAT(Grid<int32_t> const &summed_area_table)
+{
+	// find the best 3x3 square
+	int bestPower, bestX, bestY;
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	GetBestPowerSAT(bestPower, bestX, bestY, summed_area_table, 3);
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+	std::cout << "Largest total power " << bestPower << " at (" << bestX << ", " << bestY << ") [" << std::chrono::duration<float>(t2 - t1).count() << "]\n";
+}
+
+// best square of any size
+struct Square
+{
+	int power = INT_MIN, x = INT_MIN, y = INT_MIN, size = INT_MIN;
+};
+
+// find the best square of any size using the given number of threads
+void GetBestSquareSAT(Square &bestSquare, Grid<int32_t> const &summed_area_table, size_t threadCount)
+{
+	// best total power found by any thread so far
+	std::atomic<int> sharedBestPower(INT_MIN);
+
+	// best square found by each thread
+	std::vector<Square> threadBest(threadCount);
+
+	// hand out sizes from largest to smallest so that by the time the small
+	// sizes come up the best power is high enough to rule them out
+	std::atomic<int> nextSize(summed_area_table.size - 1);
+	auto worker = [&summed_area_table, &sharedBestPower, &nextSize](Square &best)
+	{
+		for (int size = nextSize--; size >= 1; size = nextSize--)
+		{
+			// skip sizes that cannot beat the best so far even if every cell had the maximum power of 4
+			if (4 * int64_t(size) * size < sharedBestPower.load())
+				continue;
+
+			// find the best <size>x<size> square
+			int curPower, curX, curY;
+			GetBestPowerSAT(curPower, curX, curY, summed_area_table, size);
+
+			// prefer the smaller size if the power is the same
+			if (best.power < curPower || (best.power == curPower && best.size > size))
+			{
+				best.power = curPower;
+				best.x = curX;
+				best.y = curY;
+				best.size = size;
+			}
+
+			// raise the shared best power
+			int shared = sharedBestPower.load();
+			while (shared < curPower && !sharedBestPower.compare_exchange_weak(shared, curPower))
+				;
+		}
+	};
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < threadCount; ++i)
+	{
+		threads.emplace_back(worker, std::ref(threadBest[i]));
+	}
+	worker(threadBest[0]);
+	for (std::thread &thread : threads)
+	{
+		thread.join();
+	}
+
+	// combine the results from each thread
+	bestSquare = Square();
+	for (Square const &cur : threadBest)
+	{
+		if (bestSquare.power < cur.power || (bestSquare.power == cur.power && bestSquare.size > cur.size))
+			bestSquare = cur;
+	}
+}
+
+void Part2SAT(Grid<int32_t> const &summed_area_table)
+{
+	// find the best square of any size
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	Square best;
+	GetBestSquareSAT(best, summed_area_table, std::max(1U, std::thread::hardware_concurrency()));
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+	std::cout << "Largest total power " << best.power << " at (" << best.x << ", " << best.y << ") size " << best.size << " [" << std::chrono::duration<float>(t2 - t1).count() << "]\n";
+}
+
+#ifdef STREAMING
+// find the best square of each size up to maxSize in a single sweep down the grid,
+// computing power values on the fly and keeping only the last maxSize+1 rows of the summed-area table
+// (bestBySize[size] holds the best square of that size)
+void StreamBestSquares(std::vector<Square> &bestBySize, int serial, int gridSize, int maxSize)
+{
+	maxSize = std::min(maxSize, gridSize);
+	bestBySize.assign(maxSize + 1, Square());
+
+	// rolling band of summed-area table rows (shifted by 1 in x and y)
+	// (sums can exceed 32 bits on large grids)
+	const int bandRows = maxSize + 1;
+	std::vector<int64_t> band(size_t(bandRows) * (gridSize + 1), 0);
+	auto row = [&band, bandRows, gridSize](int y)
+	{
+		return &band[size_t(y % bandRows) * (gridSize + 1)];
+	};
+
+	for (int y = 1; y <= gridSize; ++y)
+	{
+		// add this row of power values to the row above
+		int64_t const *above = row(y - 1);
+		int64_t *bottom = row(y);
+		int64_t rowSum = 0;
+		bottom[0] = 0;
+		for (int x = 1; x <= gridSize; ++x)
+		{
+			rowSum += GetPower(x, y, serial);
+			bottom[x] = above[x] + rowSum;
+		}
+
+		// check each square size that has its bottom edge on this row
+		for (int size = 1; size <= maxSize && size <= y; ++size)
+		{
+			// squares with their top edge on row y - size
+			// (same range as GetBestPowerSAT)
+			const int top_y = y - size;
+			if (top_y >= gridSize - size)
+				continue;
+			int64_t const *top = row(top_y);
+
+			Square &best = bestBySize[size];
+			const int count = gridSize - size;
+			for (int x = 0; x < count; ++x)
+			{
+				// compute sum over the area
+				int sum = int(top[x] - top[x + size] + bottom[x + size] - bottom[x]);
+
+				// update the best total power
+				if (best.power < sum)
+				{
+					best.power = sum;
+					best.x = x + 1;
+					best.y = top_y + 1;
+					best.size = size;
+				}
+			}
+		}
+	}
+}
+#endif
+
+#ifdef BENCHMARK
+// scalar summed-area table kernel, for comparison with the vectorized one
+void GetBestPowerSATScalar(int &bestPower, int &bestX, int &bestY, Grid<int32_t> const &summed_area_table, int size)
 {
 	bestPower = INT_MIN, bestX = INT_MIN, bestY = INT_MIN;
 
-	for (int y = 0; y < 300 - size; ++y)
+	const int count = summed_area_table.size - 1 - size;
+	for (int y = 0; y < count; ++y)
 	{
-		for (int x = 0; x < 300 - size; ++x)
+		for (int x = 0; x < count; ++x)
 		{
 			// compute sum over the area
 			int32_t sum =
@@ -134,75 +423,244 @@ void GetBestPowerSAT(int &bestPower, int &bestX, int &bestY, int32_t const (&sum
 	}
 }
 
-void Part1SAT(int32_t const (&summed_area_table)[301][301])
+// run a kernel repeatedly after warming up and report the spread of run times
+template <typename Kernel>
+void RunBenchmark(char const *name, int gridSize, Kernel kernel)
 {
-	// find the best 3x3 square
-	int bestPower, bestX, bestY;
-	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-	GetBestPowerSAT(bestPower, bestX, bestY, summed_area_table, 3);
-	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
-	std::cout << "Largest total power " << bestPower << " at (" << bestX << ", " << bestY << ") [" << std::chrono::duration<float>(t2 - t1).count() << "]\n";
+	const int warmupRuns = 3;
+	const size_t minRuns = 10;
+	const size_t maxRuns = 1000;
+	const float timeBudget = 1.0f;
+
+	// results are accumulated so the kernel can not be optimized away
+	volatile int64_t check = 0;
+
+	for (int run = 0; run < warmupRuns; ++run)
+	{
+		check += kernel();
+	}
+
+	std::vector<float> times;
+	float totalTime = 0.0f;
+	while (times.size() < minRuns || (times.size() < maxRuns && totalTime < timeBudget))
+	{
+		std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+		check += kernel();
+		std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+		float time = std::chrono::duration<float>(t2 - t1).count();
+		times.push_back(time);
+		totalTime += time;
+	}
+
+	std::sort(times.begin(), times.end());
+	float min = times.front();
+	float median = times[times.size() / 2];
+	float p99 = times[std::min(times.size() - 1, times.size() * 99 / 100)];
+	std::cout << name << " grid " << gridSize << ": min " << min << " median " << median << " p99 " << p99 << " (" << times.size() << " runs)\n";
 }
 
-void Part2SAT(int32_t const (&summed_area_table)[301][301])
+// time all the kernels across a range of grid sizes
+void Benchmark(int serial)
 {
-	// find the best square of any size
-	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-	int bestPower = INT_MIN, bestX = INT_MIN, bestY = INT_MIN, bestSize = INT_MIN;
-	for (int size = 1; size <= 300; ++size)
+	const int gridSizes[] = { 300, 600, 1200 };
+	const size_t threadCount = std::max(1U, std::thread::hardware_concurrency());
+
+	for (int gridSize : gridSizes)
 	{
-		// find the best <size>x<size> square
-		int curPower, curX, curY;
-		GetBestPowerSAT(curPower, curX, curY, summed_area_table, size);
-		if (bestPower < curPower)
+		Grid<int8_t> power;
+		BuildPowerGrid(power, gridSize, serial);
+		Grid<int32_t> summed_area_table;
+		BuildSummedAreaTable(summed_area_table, power);
+		Grid<int32_t> partial(gridSize);
+
+		RunBenchmark("summed area table", gridSize, [&]()
 		{
-			bestPower = curPower;
-			bestX = curX;
-			bestY = curY;
-			bestSize = size;
+			Grid<int32_t> table;
+			BuildSummedAreaTable(table, power);
+			return table[gridSize][gridSize];
+		});
+
+		// best 3x3 square
+		RunBenchmark("sliding window 3x3", gridSize, [&]()
+		{
+			int bestPower, bestX, bestY;
+			GetBestPower(bestPower, bestX, bestY, power, 3, partial);
+			return bestPower;
+		});
+		RunBenchmark("SAT scalar 3x3", gridSize, [&]()
+		{
+			int bestPower, bestX, bestY;
+			GetBestPowerSATScalar(bestPower, bestX, bestY, summed_area_table, 3);
+			return bestPower;
+		});
+		RunBenchmark("SAT SIMD 3x3", gridSize, [&]()
+		{
+			int bestPower, bestX, bestY;
+			GetBestPowerSAT(bestPower, bestX, bestY, summed_area_table, 3);
+			return bestPower;
+		});
+
+		// best square of any size
+		// (the sliding window takes far too long on the larger grids)
+		if (gridSize <= 300)
+		{
+			RunBenchmark("sliding window any size", gridSize, [&]()
+			{
+				int bestPower = INT_MIN;
+				for (int size = 1; size <= gridSize; ++size)
+				{
+					int curPower, curX, curY;
+					GetBestPower(curPower, curX, curY, power, size, partial);
+					bestPower = std::max(bestPower, curPower);
+				}
+				return bestPower;
+			});
+		}
+		RunBenchmark("SAT scalar any size", gridSize, [&]()
+		{
+			int bestPower = INT_MIN;
+			for (int size = 1; size <= gridSize; ++size)
+			{
+				int curPower, curX, curY;
+				GetBestPowerSATScalar(curPower, curX, curY, summed_area_table, size);
+				bestPower = std::max(bestPower, curPower);
+			}
+			return bestPower;
+		});
+		RunBenchmark("SAT SIMD pruned any size", gridSize, [&]()
+		{
+			Square best;
+			GetBestSquareSAT(best, summed_area_table, 1);
+			return best.power;
+		});
+		if (threadCount > 1)
+		{
+			RunBenchmark("SAT SIMD pruned threaded any size", gridSize, [&]()
+			{
+				Square best;
+				GetBestSquareSAT(best, summed_area_table, threadCount);
+				return best.power;
+			});
 		}
 	}
-	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
-	std::cout << "Largest total power " << bestPower << " at (" << bestX << ", " << bestY << ") size " << bestSize << " [" << std::chrono::duration<float>(t2 - t1).count() << "]\n";
 }
+#endif
 
-int main()
+#ifdef BATCH
+// a serial number and grid size to evaluate in a batch
+struct Job
 {
 	int serial;
-	std::cin >> serial;
+	int gridSize;
+	int power3, x3, y3;
+	Square best;
+	float time;
+};
 
-	// power level for each fuel cell
-	// (values range from -5 to +4)
-	int8_t power[300][300];
-	for (int y = 0; y < 300; ++y)
+// evaluate all the jobs using a pool of worker threads
+void RunBatch(std::vector<Job> &jobs)
+{
+	// each worker takes the next unclaimed job until none are left
+	std::atomic<size_t> nextJob(0);
+	auto worker = [&jobs, &nextJob]()
 	{
-		for (int x = 0; x < 300; ++x)
+		// each worker reuses its grid storage from job to job
+		Grid<int8_t> power;
+		Grid<int32_t> summed_area_table;
+		for (size_t index = nextJob++; index < jobs.size(); index = nextJob++)
 		{
-			power[y][x] = GetPower(x + 1, y + 1, serial);
+			Job &job = jobs[index];
+			std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+			BuildPowerGrid(power, job.gridSize, job.serial);
+			BuildSummedAreaTable(summed_area_table, power);
+			GetBestPowerSAT(job.power3, job.x3, job.y3, summed_area_table, 3);
+			GetBestSquareSAT(job.best, summed_area_table, 1);
+			std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+			job.time = std::chrono::duration<float>(t2 - t1).count();
 		}
+	};
+
+	size_t threadCount = std::max(1U, std::thread::hardware_concurrency());
+	threadCount = std::min(threadCount, jobs.size());
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < threadCount; ++i)
+	{
+		threads.emplace_back(worker);
+	}
+	worker();
+	for (std::thread &thread : threads)
+	{
+		thread.join();
 	}
+}
+#endif
 
-	Part1(power);
-	Part2(power);
+int main()
+{
+#if defined(STREAMING)
+	int serial;
+	std::cin >> serial;
 
-	// build summed-area table (shifted by 1 in x and y)
+	// find the best square of each size
 	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-	int32_t summed_area_table[301][301] = { 0 };
-	for (int y = 0; y < 300; ++y)
+	std::vector<Square> bestBySize;
+	StreamBestSquares(bestBySize, serial, STREAMING_GRID_SIZE, STREAMING_MAX_SIZE);
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+	Square best;
+	for (int size = 1; size < int(bestBySize.size()); ++size)
 	{
-		for (int x = 0; x < 300; ++x)
-		{
-			summed_area_table[y + 1][x + 1] = power[y][x];
-			summed_area_table[y + 1][x + 1] += summed_area_table[y][x + 1];
-			summed_area_table[y + 1][x + 1] -= summed_area_table[y][x];
-			summed_area_table[y + 1][x + 1] += summed_area_table[y + 1][x];
-		}
+		Square const &cur = bestBySize[size];
+		std::cout << "Size " << size << " largest total power " << cur.power << " at (" << cur.x << ", " << cur.y << ")\n";
+		if (best.power < cur.power)
+			best = cur;
+	}
+	std::cout << "Largest total power " << best.power << " at (" << best.x << ", " << best.y << ") size " << best.size << " [" << std::chrono::duration<float>(t2 - t1).count() << "]\n";
+#elif defined(BENCHMARK)
+	int serial;
+	std::cin >> serial;
+
+	Benchmark(serial);
+#elif defined(BATCH)
+	// get the serial number and optional grid size for each job
+	std::vector<Job> jobs;
+	char line[256];
+	while (std::cin.getline(line, sizeof(line)))
+	{
+		Job job = {};
+		job.gridSize = DEFAULT_GRID_SIZE;
+		if (sscanf_s(line, "%d %d", &job.serial, &job.gridSize) >= 1)
+			jobs.push_back(job);
+	}
+
+	RunBatch(jobs);
+
+	// report results in input order
+	for (Job const &job : jobs)
+	{
+		std::cout << "serial " << job.serial << " grid " << job.gridSize << ": largest 3x3 power " << job.power3 << " at (" << job.x3 << ", " << job.y3 << "), largest power " << job.best.power << " at (" << job.best.x << ", " << job.best.y << ") size " << job.best.size << " [" << job.time << "]\n";
 	}
+#else
+	int serial;
+	std::cin >> serial;
+
+	// power level for each fuel cell
+	Grid<int8_t> power;
+	BuildPowerGrid(power, DEFAULT_GRID_SIZE, serial);
+
+	Part1(power);
+	Part2(power);
+
+	// build summed-area table
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	Grid<int32_t> summed_area_table;
+	BuildSummedAreaTable(summed_area_table, power);
 	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
 	std::cout << "summed area table [" << std::chrono::duration<float>(t2 - t1).count() << "]\n";
 
 	Part1SAT(summed_area_table);
 	Part2SAT(summed_area_table);
+#endif
 
 	return 0;
 }
\ No newline at end of file
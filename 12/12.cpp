@@ -1,48 +1,204 @@
 #include <iostream>
 #include <vector>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 // https://adventofcode.com/2018/day/12
 
+// print the pots of each generation
+//#define TRACE
+#ifdef TRACE
+const int64_t TRACE_INTERVAL = 1;			// only print every Nth generation
+const size_t TRACE_BUFFER_SIZE = 1 << 20;	// bytes collected before writing them out
+#endif
+
+// skip through the generations with a hashed tree of memoised row pieces
+// (reaches far generations when the plants keep repeating structure, even without settling into a cycle;
+// chaotic rules that never repeat can't be skipped ahead like this, so the run gives up at the memory limit)
+//#define HASHLIFE
+#ifdef HASHLIFE
+const size_t HASHLIFE_MEMORY_LIMIT = size_t(1) << 30;	// approximate bytes of nodes and memoised results kept at once
+#endif
+
+// index of the lowest set bit (value must be non-zero)
+inline int CountTrailingZeros(uint64_t value)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+	unsigned long index;
+	_BitScanForward64(&index, value);
+	return int(index);
+#elif defined(_MSC_VER)
+	unsigned long index;
+	if (_BitScanForward(&index, static_cast<unsigned long>(value)))
+		return int(index);
+	_BitScanForward(&index, static_cast<unsigned long>(value >> 32));
+	return 32 + int(index);
+#else
+	return __builtin_ctzll(value);
+#endif
+}
+
+// number of clear bits above the highest set bit (value must be non-zero)
+inline int CountLeadingZeros(uint64_t value)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+	unsigned long index;
+	_BitScanReverse64(&index, value);
+	return 63 - int(index);
+#elif defined(_MSC_VER)
+	unsigned long index;
+	if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32)))
+		return 31 - int(index);
+	_BitScanReverse(&index, static_cast<unsigned long>(value));
+	return 63 - int(index);
+#else
+	return __builtin_clzll(value);
+#endif
+}
+
+// pots packed 64 to a word
+// (pot i is bit i % 64 of word i / 64)
 struct State
 {
-	std::vector<bool> occupied;
+	std::vector<uint64_t> words;
 	int lower = 0;
-	int upper = 0;
+	int upper = -1;
 	int64_t offset = 0;
 };
 
+// rule giving the next state of a pot from its neighbourhood
+struct Rule
+{
+	// indexed by (LL << 0) | (L << 1) | (C << 2) | (R << 3) | (RR << 4)
+	bool patterns[1 << 5] = {};
+
+	// the same table with each entry widened to all zeros or all ones
+	// (so 64 pots can be evaluated at once)
+	uint64_t masks[1 << 5] = {};
+};
+
 void UpdateBounds(State &state)
 {
+	const int wordCount = int(state.words.size());
+
 	// compute lower bound (minus offset)
-	for (int i = 0; i < state.occupied.size(); ++i)
+	int first = 0;
+	while (first < wordCount && state.words[first] == 0)
+		++first;
+	if (first == wordCount)
 	{
-		if (state.occupied[i])
-		{
-			state.lower = i;
-			break;
-		}
+		// no occupied locations
+		state.lower = 0;
+		state.upper = -1;
+		return;
 	}
+	state.lower = first * 64 + CountTrailingZeros(state.words[first]);
 
 	// compute upper bound (minus offset)
-	for (int i = 0; i < state.occupied.size(); ++i)
+	int last = wordCount - 1;
+	while (state.words[last] == 0)
+		--last;
+	state.upper = last * 64 + 63 - CountLeadingZeros(state.words[last]);
+}
+
+// get the 64 pots starting at a location (minus offset)
+inline uint64_t GetBits(State const &state, int position)
+{
+	const int wordCount = int(state.words.size());
+	const int word = position >> 6;
+	const int bit = position & 63;
+	uint64_t bits = word >= 0 && word < wordCount ? state.words[word] >> bit : 0;
+	if (bit != 0 && word + 1 >= 0 && word + 1 < wordCount)
+		bits |= state.words[word + 1] << (64 - bit);
+	return bits;
+}
+
+// get the occupied pots with the empty pots either side trimmed off
+// (pot lower is bit 0 of the first word and any bits past upper are clear)
+void GetPattern(std::vector<uint64_t> &output, State const &state)
+{
+	const int length = state.upper - state.lower + 1;
+	output.resize((length + 63) / 64);
+	for (int i = 0; i < int(output.size()); ++i)
 	{
-		if (state.occupied[i])
-		{
-			state.upper = i;
-		}
+		output[i] = GetBits(state, state.lower + i * 64);
 	}
+	if (length & 63)
+		output.back() &= (uint64_t(1) << (length & 63)) - 1;
 }
 
-void PrintState(int64_t generation, State const &state)
+// hash a trimmed pattern
+uint64_t HashPattern(std::vector<uint64_t> const &pattern)
 {
-	std::cout << generation << ": ";
-	for (int i = 0; i < int(state.occupied.size()); ++i)
+	uint64_t hash = 14695981039346656037ull;
+	for (uint64_t word : pattern)
 	{
-		std::cout << (state.occupied[i] ? '#' : '.');
+		hash = (hash ^ word) * 1099511628211ull;
+		hash ^= hash >> 29;
 	}
-	std::cout << "\n";
+	return hash;
 }
 
+#ifdef TRACE
+// collects the printed generations and writes them out in large blocks
+class Trace
+{
+public:
+	Trace()
+	{
+		buffer.reserve(TRACE_BUFFER_SIZE);
+	}
+
+	~Trace()
+	{
+		Flush();
+	}
+
+	// add a line showing the pots of a generation
+	void Print(int64_t generation, State const &state)
+	{
+		if (generation % TRACE_INTERVAL != 0)
+			return;
+
+		const std::string label = std::to_string(generation) + ": ";
+		const int length = state.upper - state.lower + 1;
+		if (buffer.size() + label.size() + length + 1 > buffer.capacity())
+			Flush();
+
+		// expand the pots directly into the buffer
+		buffer += label;
+		size_t start = buffer.size();
+		buffer.resize(start + length);
+		char *pots = &buffer[start];
+		for (int i = 0; i < length; i += 64)
+		{
+			uint64_t bits = GetBits(state, state.lower + i);
+			for (int j = 0; j < 64 && i + j < length; ++j, bits >>= 1)
+			{
+				pots[i + j] = bits & 1 ? '#' : '.';
+			}
+		}
+		buffer += '\n';
+	}
+
+	// write out the collected lines
+	void Flush()
+	{
+		std::cout.write(buffer.data(), buffer.size());
+		buffer.clear();
+	}
+
+private:
+	std::string buffer;
+};
+#endif
+
 // read in the initial state
 void ReadInitial(State &output, std::istream &input)
 {
@@ -50,18 +206,20 @@ void ReadInitial(State &output, std::istream &input)
 	input.getline(line, sizeof(line));
 	char state[256];
 	sscanf_s(line, "initial state: %s", state, unsigned int(sizeof(state)));
-	for (char const element : state)
+	output.words.clear();
+	for (int i = 0; state[i] != '\0'; ++i)
 	{
-		if (element == '\0')
-			break;
-		output.occupied.push_back(element == '#');
+		if ((i & 63) == 0)
+			output.words.push_back(0);
+		if (state[i] == '#')
+			output.words[i >> 6] |= uint64_t(1) << (i & 63);
 	}
 	output.offset = 0;
 	UpdateBounds(output);
 }
 
 // read in the patterns
-void ReadPatterns(std::vector<bool> &output, std::istream &input)
+void ReadPatterns(Rule &output, std::istream &input)
 {
 	char line[256];
 	while (input.getline(line, sizeof(line)))
@@ -69,67 +227,155 @@ void ReadPatterns(std::vector<bool> &output, std::istream &input)
 		char iLL, iL, iC, iR, iRR, o;
 		if (sscanf_s(line, "%c%c%c%c%c => %c", &iLL, 1, &iL, 1, &iC, 1, &iR, 1, &iRR, 1, &o, 1) == 6)
 		{
-			output[((iLL == '#') << 0) | ((iL == '#') << 1) | ((iC == '#') << 2) | ((iR == '#') << 3) | ((iRR == '#') << 4)] = (o == '#');
+			output.patterns[((iLL == '#') << 0) | ((iL == '#') << 1) | ((iC == '#') << 2) | ((iR == '#') << 3) | ((iRR == '#') << 4)] = (o == '#');
 		}
 	}
+
+	for (int i = 0; i < (1 << 5); ++i)
+	{
+		output.masks[i] = output.patterns[i] ? ~uint64_t(0) : 0;
+	}
+}
+
+// pick bits from ifSet where the selector is set and from ifClear where it is clear
+inline uint64_t Select(uint64_t selector, uint64_t ifSet, uint64_t ifClear)
+{
+	return ifClear ^ ((ifClear ^ ifSet) & selector);
+}
+
+// apply the rule to 64 pots at once, given each pot's neighbours at the same bit position
+// (a tree of selects over the pattern table, one level per neighbour)
+inline uint64_t ApplyRule(Rule const &rule, uint64_t iLL, uint64_t iL, uint64_t iC, uint64_t iR, uint64_t iRR)
+{
+	uint64_t level[16];
+	for (int i = 0; i < 16; ++i)
+		level[i] = Select(iLL, rule.masks[i * 2 + 1], rule.masks[i * 2]);
+	for (int i = 0; i < 8; ++i)
+		level[i] = Select(iL, level[i * 2 + 1], level[i * 2]);
+	for (int i = 0; i < 4; ++i)
+		level[i] = Select(iC, level[i * 2 + 1], level[i * 2]);
+	for (int i = 0; i < 2; ++i)
+		level[i] = Select(iR, level[i * 2 + 1], level[i * 2]);
+	return Select(iRR, level[1], level[0]);
 }
 
 // perform one iteration
-void Iterate(State &output, State const &input, std::vector<bool> const &patterns)
+void Iterate(State &output, State const &input, Rule const &rule)
 {
-	// resize the output to hold the largest possible result
-	output.occupied.resize(input.upper - input.lower + 1 + 2 + 2);
+	// the output covers the occupied input words plus one word either side
+	// (a pot only affects its neighbours up to two pots away)
+	const int firstWord = (input.lower >> 6) - 1;
+	const int lastWord = (input.upper >> 6) + 1;
+	output.words.resize(lastWord - firstWord + 1);
 
-	// for each output location...
-	for (int i = input.lower - 2; i < input.upper + 2; ++i)
+	// for each output word...
+	uint64_t prev = 0;
+	uint64_t curr = GetBits(input, firstWord * 64);
+	for (int word = firstWord; word <= lastWord; ++word)
 	{
-		// compute the new output based on inputs
-		const bool iLL = i >= input.lower + 2 && i <= input.upper + 2 && input.occupied[i - 2];
-		const bool iL =  i >= input.lower + 1 && i <= input.upper + 1 && input.occupied[i - 1];
-		const bool iC =  i >= input.lower + 0 && i <= input.upper     && input.occupied[i    ];
-		const bool iR =  i >= input.lower - 1 && i <= input.upper - 1 && input.occupied[i + 1];
-		const bool iRR = i >= input.lower - 2 && i <= input.upper - 2 && input.occupied[i + 2];
-		output.occupied[i - input.lower + 2] = patterns[(iLL << 0) | (iL << 1) | (iC << 2) | (iR << 3) | (iRR << 4)];
+		const uint64_t next = GetBits(input, (word + 1) * 64);
+
+		// line up each neighbour with the pot it affects
+		const uint64_t iLL = (curr << 2) | (prev >> 62);
+		const uint64_t iL  = (curr << 1) | (prev >> 63);
+		const uint64_t iRR = (curr >> 2) | (next << 62);
+		const uint64_t iR  = (curr >> 1) | (next << 63);
+		output.words[word - firstWord] = ApplyRule(rule, iLL, iL, curr, iR, iRR);
+
+		prev = curr;
+		curr = next;
 	}
 
 	// update the bounds and offset
 	UpdateBounds(output);
-	output.offset = input.offset + input.lower - 2;
+	output.offset = input.offset + int64_t(firstWord) * 64;
+}
+
+// trimmed pattern seen at a generation and the location of its first pot
+struct Snapshot
+{
+	std::vector<uint64_t> pattern;
+	int length = 0;
+	int64_t position = 0;
+};
+
+// set a state to a trimmed pattern placed at a location
+void SetPattern(State &output, Snapshot const &snapshot, int64_t position)
+{
+	output.words = snapshot.pattern;
+	output.offset = position;
+	UpdateBounds(output);
 }
 
 // run the simulation from an initial state for a specified number of generations
-void RunSimulation(State &result, State const &initial, std::vector<bool> const &patterns, int64_t generations)
+void RunSimulation(State &result, State const &initial, Rule const &rule, int64_t generations)
 {
 	State next;
 
-	// print initial state
-	PrintState(0, initial);
+	// trimmed pattern for every generation so far
+	// and the generations that produced each pattern hash
+	std::vector<Snapshot> history;
+	std::unordered_multimap<uint64_t, int64_t> seen;
+
+#ifdef TRACE
+	Trace trace;
+#endif
 
 	// start with the initial state
 	result = initial;
 
 	// for each generation...
-	for (int64_t generation = 1; generation <= generations; ++generation)
+	for (int64_t generation = 0; generation <= generations; ++generation)
 	{
 		// get new state
-		Iterate(next, result, patterns);
+		if (generation > 0)
+		{
+			Iterate(next, result, rule);
 
+			// exchange states
+			std::swap(next, result);
+		}
+
+#ifdef TRACE
 		// print new state
-		PrintState(generation + 1, next);
+		trace.Print(generation, result);
+#endif
 
-		// exchange states
-		std::swap(next, result);
+		// record the trimmed pattern
+		// (an empty row has no position, so it always matches itself in place)
+		Snapshot snapshot;
+		GetPattern(snapshot.pattern, result);
+		snapshot.length = result.upper - result.lower + 1;
+		snapshot.position = snapshot.length > 0 ? result.offset + result.lower : 0;
+		const uint64_t hash = HashPattern(snapshot.pattern);
 
-		// if the occupied locations reach equilibrium...
-		if (next.lower == result.lower && next.upper == result.upper && next.occupied == result.occupied)
+		// if the pattern has been seen before...
+		auto range = seen.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it)
 		{
-			// compute what the result would be at the end
-			std::cout << "reached equilibrium at generation " << generation << "\n"; 
-			std::cout << "each generation changes offset by " << result.offset - next.offset << "\n";
-			std::cout << "applying offset for remaining " << generations - generation << " generations\n";
-			result.offset += (result.offset - next.offset) * (generations - generation);
-			break;
+			Snapshot const &earlier = history[it->second];
+			if (earlier.length != snapshot.length || earlier.pattern != snapshot.pattern)
+				continue;
+
+			// every later generation repeats the one a period before it, moved by the same drift
+			const int64_t period = generation - it->second;
+			const int64_t drift = snapshot.position - earlier.position;
+			const int64_t remaining = generations - generation;
+#ifdef TRACE
+			trace.Flush();
+#endif
+			std::cout << "generation " << generation << " repeats generation " << it->second << " (period " << period << ")\n";
+			std::cout << "each period changes offset by " << drift << "\n";
+			std::cout << "applying offset for remaining " << remaining << " generations\n";
+
+			// the final generation matches one inside the first period
+			Snapshot const &last = history[it->second + remaining % period];
+			SetPattern(result, last, last.position + drift * (remaining / period + 1));
+			return;
 		}
+
+		seen.emplace(hash, generation);
+		history.push_back(std::move(snapshot));
 	}
 }
 
@@ -137,29 +383,353 @@ int64_t ComputeSum(State const &state)
 {
 	// sum of the indices of the occupied locations
 	int64_t sum = 0;
-	for (int i = state.lower; i <= state.upper; ++i)
+	for (int word = 0; word < int(state.words.size()); ++word)
 	{
-		if (state.occupied[i])
-			sum += i + state.offset;
+		for (uint64_t bits = state.words[word]; bits != 0; bits &= bits - 1)
+		{
+			sum += word * 64 + CountTrailingZeros(bits) + state.offset;
+		}
 	}
 	return sum;
 }
 
-void Part1(State const &initial, std::vector<bool> const &patterns)
+#ifdef HASHLIFE
+// runs the simulation on a row stored as a tree of shared, hashed nodes
+// (a node at level k covers 2^k pots and remembers its middle half some power of two generations on,
+// so repeated structure is only ever simulated once and whole runs of generations can be skipped at a time)
+class Hashlife
+{
+public:
+	Hashlife(Rule const &rule, size_t memoryLimit)
+		: rule(rule)
+		, nodeLimit(memoryLimit / BYTES_PER_NODE)
+	{
+	}
+
+	// run the simulation from an initial state for a specified number of generations
+	// and get the sum of the indices of the occupied locations
+	// (returns false if a step doesn't fit in the memory limit)
+	bool Run(State const &initial, int64_t generations, int64_t &sum)
+	{
+		Build(initial);
+
+		// advance by each power of two in the generation count, largest first
+		for (int step = 62; step >= 0; --step)
+		{
+			if (((generations >> step) & 1) == 0)
+				continue;
+
+			// pad the row until the plants sit in the middle quarter and the root can take the step
+			// (plants spread at most two pots per generation, so they stay inside the middle half)
+			while (nodes[root].level < step + 4 || !IsCentred(root))
+				Expand();
+
+			int result = Advance(root, step);
+			if (result < 0)
+			{
+				// out of room, so keep only the current row and try again
+				// (if the step still doesn't fit, the row has too little repeated structure to skip ahead)
+				Collect();
+				result = Advance(root, step);
+				if (result < 0)
+					return false;
+			}
+
+			// the result is the middle half of the root
+			origin += int64_t(1) << (nodes[root].level - 2);
+			root = result;
+		}
+
+		sum = ComputeSum();
+		return true;
+	}
+
+private:
+	// leaves hold a word of 64 pots
+	static const int LEAF_LEVEL = 6;
+
+	// approximate memory used by a node or memoised result and its table entries
+	static const size_t BYTES_PER_NODE = 128;
+
+	struct Node
+	{
+		int level;
+		int left;		// child nodes (unused for leaves)
+		int right;
+		uint64_t bits;	// pots (leaves only)
+	};
+
+	// get the node for a word of pots
+	int Leaf(uint64_t bits)
+	{
+		auto found = leaves.find(bits);
+		if (found != leaves.end())
+			return found->second;
+		nodes.push_back({ LEAF_LEVEL, -1, -1, bits });
+		leaves.emplace(bits, int(nodes.size()) - 1);
+		return int(nodes.size()) - 1;
+	}
+
+	// get the node for two adjacent nodes of the same level
+	int Join(int left, int right)
+	{
+		const uint64_t key = (uint64_t(uint32_t(left)) << 32) | uint32_t(right);
+		auto found = joins.find(key);
+		if (found != joins.end())
+			return found->second;
+		nodes.push_back({ nodes[left].level + 1, left, right, 0 });
+		joins.emplace(key, int(nodes.size()) - 1);
+		return int(nodes.size()) - 1;
+	}
+
+	// get the node with no plants at a level
+	int Empty(int level)
+	{
+		if (level == LEAF_LEVEL)
+			return Leaf(0);
+		const int half = Empty(level - 1);
+		return Join(half, half);
+	}
+
+	// check if a node has no plants
+	bool IsEmpty(int node)
+	{
+		return node == Empty(nodes[node].level);
+	}
+
+	// check if the plants under a node are all in its middle quarter
+	bool IsCentred(int node)
+	{
+		if (nodes[node].level < LEAF_LEVEL + 3)
+			return false;
+		const int left = nodes[node].left;
+		const int right = nodes[node].right;
+		const int leftInner = nodes[left].right;
+		const int rightInner = nodes[right].left;
+		return IsEmpty(nodes[left].left) && IsEmpty(nodes[leftInner].left)
+			&& IsEmpty(nodes[right].right) && IsEmpty(nodes[rightInner].right);
+	}
+
+	// double the size of the root, keeping it in the middle
+	void Expand()
+	{
+		Node const &top = nodes[root];
+		const int level = top.level;
+		const int left = top.left;
+		const int right = top.right;
+		const int empty = Empty(level - 1);
+		root = Join(Join(empty, left), Join(right, empty));
+		origin -= int64_t(1) << (level - 1);
+	}
+
+	// get the middle half of a node
+	int Centre(int node)
+	{
+		const int left = nodes[node].left;
+		const int right = nodes[node].right;
+		if (nodes[node].level == LEAF_LEVEL + 1)
+			return Leaf((nodes[left].bits >> 32) | (nodes[right].bits << 32));
+		return Join(nodes[left].right, nodes[right].left);
+	}
+
+	// get the middle half of a node 2^step generations on
+	// (step can be at most the node's level minus 3; returns -1 once the stored nodes and results reach the memory limit)
+	int Advance(int node, int step)
+	{
+		if (nodes.size() + results.size() > nodeLimit)
+			return -1;
+
+		const uint64_t key = (uint64_t(uint32_t(node)) << 6) | uint32_t(step);
+		auto found = results.find(key);
+		if (found != results.end())
+			return found->second;
+
+		const Node parent = nodes[node];
+		int result;
+		if (parent.level == LEAF_LEVEL + 1)
+		{
+			// simulate the two leaves directly
+			// (pots beyond them are treated as empty, which only disturbs the outer quarters)
+			uint64_t low = nodes[parent.left].bits;
+			uint64_t high = nodes[parent.right].bits;
+			for (int generation = 0; generation < (1 << step); ++generation)
+			{
+				const uint64_t nextLow = ApplyRule(rule, low << 2, low << 1, low, (low >> 1) | (high << 63), (low >> 2) | (high << 62));
+				const uint64_t nextHigh = ApplyRule(rule, (high << 2) | (low >> 62), (high << 1) | (low >> 63), high, high >> 1, high >> 2);
+				low = nextLow;
+				high = nextHigh;
+			}
+			result = Leaf((low >> 32) | (high << 32));
+		}
+		else
+		{
+			// split into quarters and advance the three overlapping halves
+			const int firstStep = std::min(step, parent.level - 4);
+			const int left = Advance(parent.left, firstStep);
+			const int middle = Advance(Join(nodes[parent.left].right, nodes[parent.right].left), firstStep);
+			const int right = Advance(parent.right, firstStep);
+			if (left < 0 || middle < 0 || right < 0)
+				return -1;
+
+			if (step == parent.level - 3)
+			{
+				// advance the two halves again to cover the whole step
+				const int newLeft = Advance(Join(left, middle), firstStep);
+				const int newRight = Advance(Join(middle, right), firstStep);
+				if (newLeft < 0 || newRight < 0)
+					return -1;
+				result = Join(newLeft, newRight);
+			}
+			else
+			{
+				// the step is already covered, so just take the middle
+				result = Join(Centre(Join(left, middle)), Centre(Join(middle, right)));
+			}
+		}
+
+		results.emplace(key, result);
+		return result;
+	}
+
+	// build the tree for a state
+	void Build(State const &initial)
+	{
+		Clear();
+
+		std::vector<uint64_t> pattern;
+		GetPattern(pattern, initial);
+		origin = initial.upper >= initial.lower ? initial.offset + initial.lower : 0;
+
+		// one leaf per word, padded to a power of two
+		std::vector<int> level;
+		for (uint64_t bits : pattern)
+			level.push_back(Leaf(bits));
+		while (level.size() < 2 || (level.size() & (level.size() - 1)) != 0)
+			level.push_back(Leaf(0));
+
+		// join pairs until there is a single root
+		while (level.size() > 1)
+		{
+			for (size_t i = 0; i < level.size() / 2; ++i)
+				level[i] = Join(level[i * 2], level[i * 2 + 1]);
+			level.resize(level.size() / 2);
+		}
+		root = level[0];
+	}
+
+	// forget every node that is not part of the current row
+	void Collect()
+	{
+		std::vector<Node> oldNodes;
+		std::swap(oldNodes, nodes);
+		Clear();
+
+		// copy the root's tree into the emptied tables
+		std::unordered_map<int, int> copies;
+		std::function<int(int)> copy = [&](int node) -> int
+		{
+			auto found = copies.find(node);
+			if (found != copies.end())
+				return found->second;
+			Node const &old = oldNodes[node];
+			const int result = old.level == LEAF_LEVEL ? Leaf(old.bits) : Join(copy(old.left), copy(old.right));
+			copies.emplace(node, result);
+			return result;
+		};
+		root = copy(root);
+	}
+
+	void Clear()
+	{
+		nodes.clear();
+		leaves.clear();
+		joins.clear();
+		results.clear();
+	}
+
+	// sum of the indices of the occupied locations under the root
+	int64_t ComputeSum()
+	{
+		// plant count and index sum (from the start of the node) for each node
+		std::unordered_map<int, std::pair<int64_t, int64_t>> sums;
+		std::function<std::pair<int64_t, int64_t>(int)> sum = [&](int node) -> std::pair<int64_t, int64_t>
+		{
+			auto found = sums.find(node);
+			if (found != sums.end())
+				return found->second;
+			Node const &n = nodes[node];
+			std::pair<int64_t, int64_t> result(0, 0);
+			if (n.level == LEAF_LEVEL)
+			{
+				for (uint64_t bits = n.bits; bits != 0; bits &= bits - 1)
+				{
+					++result.first;
+					result.second += CountTrailingZeros(bits);
+				}
+			}
+			else
+			{
+				const std::pair<int64_t, int64_t> left = sum(n.left);
+				const std::pair<int64_t, int64_t> right = sum(n.right);
+				result.first = left.first + right.first;
+				result.second = left.second + right.second + right.first * (int64_t(1) << (n.level - 1));
+			}
+			sums.emplace(node, result);
+			return result;
+		};
+
+		const std::pair<int64_t, int64_t> total = sum(root);
+		return total.second + total.first * origin;
+	}
+
+	Rule const &rule;
+	size_t nodeLimit;
+
+	std::vector<Node> nodes;
+	std::unordered_map<uint64_t, int> leaves;	// node for each word of pots
+	std::unordered_map<uint64_t, int> joins;	// node for each pair of child nodes
+	std::unordered_map<uint64_t, int> results;	// advanced middle half for each node and step
+
+	int root = -1;
+	int64_t origin = 0;		// index of the root's first pot
+};
+#endif
+
+void Part1(State const &initial, Rule const &rule)
 {
 	// run simulation for 20 generations
+#ifdef HASHLIFE
+	Hashlife hashlife(rule, HASHLIFE_MEMORY_LIMIT);
+	int64_t sum = 0;
+	if (!hashlife.Run(initial, 20, sum))
+	{
+		std::cout << "Part 1: plants don't repeat enough to skip ahead within the memory limit\n";
+		return;
+	}
+#else
 	State result;
-	RunSimulation(result, initial, patterns, 20);
+	RunSimulation(result, initial, rule, 20);
 	int64_t sum = ComputeSum(result);
+#endif
 	std::cout << "Part 1: plant position sum is " << sum << "\n";
 }
 
-void Part2(State const &initial, std::vector<bool> const &patterns)
+void Part2(State const &initial, Rule const &rule)
 {
 	// run simulation for 50 billion generations
+#ifdef HASHLIFE
+	Hashlife hashlife(rule, HASHLIFE_MEMORY_LIMIT);
+	int64_t sum = 0;
+	if (!hashlife.Run(initial, 50000000000, sum))
+	{
+		std::cout << "Part 2: plants don't repeat enough to skip ahead within the memory limit\n";
+		return;
+	}
+#else
 	State result;
-	RunSimulation(result, initial, patterns, 50000000000);
+	RunSimulation(result, initial, rule, 50000000000);
 	int64_t sum = ComputeSum(result);
+#endif
 	std::cout << "Part 2: plant position sum is " << sum << "\n";
 }
 
@@ -170,11 +740,11 @@ int main()
 	ReadInitial(initial, std::cin);
 
 	// read patterns
-	std::vector<bool> patterns(1 << 5, false);
-	ReadPatterns(patterns, std::cin);
+	Rule rule;
+	ReadPatterns(rule, std::cin);
 
-	Part1(initial, patterns);
-	Part2(initial, patterns);
+	Part1(initial, rule);
+	Part2(initial, rule);
 
 	return 0;
 }
\ No newline at end of file
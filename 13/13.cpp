@@ -2,6 +2,8 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <queue>
+#include <functional>
 #include <assert.h>
 
 https://adventofcode.com/2018/day/13
@@ -15,6 +17,9 @@ https://adventofcode.com/2018/day/13
 // 3rd time: turn right
 // then repeats the pattern
 
+// simulate a segment of track at a time instead of a cell at a time
+//#define EVENT_DRIVEN
+
 enum class Direction : char
 {
 	Up = 0, Right = 1, Down = 2, Left = 3, Count = 4
@@ -46,9 +51,10 @@ struct Cart
 {
 	Position pos;	// current position
 	Direction dir;	// current direction
-	char under;		// what's under the cart
 	Turn turn;		// next turn direction
-	char id;
+	int id;
+	bool crashed;	// removed after a collision (dropped at the end of the tick)
+	bool movedRow;	// moved up or down on the latest tick
 };
 
 bool operator<(Cart const &a, Cart const &b)
@@ -56,141 +62,512 @@ bool operator<(Cart const &a, Cart const &b)
 	return a.pos < b.pos;
 }
 
-void Simulate(std::string const &layout, short width, short height, int part)
+// collision between two carts
+struct Crash
 {
-	// cart locations
+	int tick;
+	Position pos;
+	int cart;	// id of the cart that moved
+	int other;	// id of the cart it ran into
+};
+
+// receives each crash as it happens
+typedef std::function<void(Crash const &)> CrashSink;
+
+// move one step in a direction
+void Move(Position &pos, Direction dir)
+{
+	switch (dir)
+	{
+	case Direction::Up:		--pos.y; break;
+	case Direction::Right:	++pos.x; break;
+	case Direction::Down:	++pos.y; break;
+	case Direction::Left:	--pos.x; break;
+	}
+}
+
+// update the direction and next turn for the track a cart has moved onto
+void Steer(Direction &dir, Turn &turn, char track)
+{
+	switch (track)
+	{
+	case '/':
+		// track curve
+		switch (dir)
+		{
+		case Direction::Up:		dir = Direction::Right; break;
+		case Direction::Right:	dir = Direction::Up; break;
+		case Direction::Down:	dir = Direction::Left; break;
+		case Direction::Left:	dir = Direction::Down; break;
+		}
+		break;
+
+	case '\\':
+		// track curve
+		switch (dir)
+		{
+		case Direction::Up:		dir = Direction::Left; break;
+		case Direction::Right:	dir = Direction::Down; break;
+		case Direction::Down:	dir = Direction::Right; break;
+		case Direction::Left:	dir = Direction::Up; break;
+		}
+		break;
+
+	case '+':
+		// intersection
+		switch (turn)
+		{
+		case Turn::Left:
+			dir = Direction((int(dir) + int(Direction::Count) - 1) % int(Direction::Count));
+			break;
+		case Turn::Right:
+			dir = Direction((int(dir) + 1) % int(Direction::Count));
+			break;
+		}
+		turn = Turn((int(turn) + 1) % int(Turn::Count));
+	}
+}
+
+// find the carts in the initial layout
+// (the track under each cart is restored in the track map)
+void ReadCarts(std::vector<Cart> &carts, std::string &track, std::string const &layout, short width)
+{
+	track = layout;
 	short x = 0, y = 0;
-	char id = 0;
-	std::vector<Cart> carts;
+	int id = 0;
 	for (char const c : layout)
 	{
 		switch (c)
 		{
-		case '^': carts.push_back({ {x, y}, Direction::Up,    '|', Turn::Left, id++ }); break;
-		case '>': carts.push_back({ {x, y}, Direction::Right, '-', Turn::Left, id++ }); break;
-		case 'v': carts.push_back({ {x, y}, Direction::Down,  '|', Turn::Left, id++ }); break;
-		case '<': carts.push_back({ {x, y}, Direction::Left,  '-', Turn::Left, id++ }); break;
+		case '^': carts.push_back({ {x, y}, Direction::Up,    Turn::Left, id++, false, false }); track[y * width + x] = '|'; break;
+		case '>': carts.push_back({ {x, y}, Direction::Right, Turn::Left, id++, false, false }); track[y * width + x] = '-'; break;
+		case 'v': carts.push_back({ {x, y}, Direction::Down,  Turn::Left, id++, false, false }); track[y * width + x] = '|'; break;
+		case '<': carts.push_back({ {x, y}, Direction::Left,  Turn::Left, id++, false, false }); track[y * width + x] = '-'; break;
 		case '\n': x = -1; ++y; break;
 		}
 
 		++x;
 	}
+}
 
-	const char image[int(Direction::Count)] = { '^', '>', 'v', '<' };
+// run the carts until at most one remains, passing every crash to the sink
+// (returns true with the location of the last cart after its final tick, or false if none remain)
+bool Simulate(std::string const &layout, short width, short height, CrashSink const &sink, Position &last)
+{
+	// cart locations
+	std::string track;
+	std::vector<Cart> carts;
+	ReadCarts(carts, track, layout, width);
 
-	std::string state = layout;
+	// index of the cart at each location (or -1 if empty)
+	std::vector<int> occupancy(track.size(), -1);
+	for (int i = 0; i < int(carts.size()); ++i)
+	{
+		occupancy[carts[i].pos.y * width + carts[i].pos.x] = i;
+	}
+	int remaining = int(carts.size());
 
 	for (int tick = 0; ; ++tick)
 	{
 		// perform one "tick"
-		for (int i = 0; i < carts.size(); ++i)
+		for (int i = 0; i < int(carts.size()); ++i)
 		{
 			Cart &cart = carts[i];
+			if (cart.crashed)
+				continue;
 
-			// restore the track
-			state[cart.pos.y * width + cart.pos.x] = cart.under;
+			// leave the current location
+			occupancy[cart.pos.y * width + cart.pos.x] = -1;
 
 			// get the new position
-			switch (cart.dir)
-			{
-			case Direction::Up:		--cart.pos.y; break;
-			case Direction::Right:	++cart.pos.x; break;
-			case Direction::Down:	++cart.pos.y; break;
-			case Direction::Left:	--cart.pos.x; break;
-			}
+			Move(cart.pos, cart.dir);
+			cart.movedRow = cart.dir == Direction::Up || cart.dir == Direction::Down;
 			assert(cart.pos.x >= 0 && cart.pos.x < width && cart.pos.y >= 0 && cart.pos.y < height);
 
-			// update based on what's at the new position
-			switch (state[cart.pos.y * width + cart.pos.x])
+			int &occupant = occupancy[cart.pos.y * width + cart.pos.x];
+			if (occupant >= 0)
 			{
-			case '^':
-			case '>':
-			case 'v':
-			case '<':
 				// collided with another cart
-				std::cout << "Part " << part << ": crash at " << cart.pos.x << ", " << cart.pos.y << " on tick " << tick << "\n";
-				state[cart.pos.y * width + cart.pos.x] = 'X';
-
-				if (part == 1)
-				{
-					// for part 1, stop on the first collision
-					return;
-				}
+				sink({ tick, cart.pos, cart.id, carts[occupant].id });
 
 				// remove the colliding carts
-				for (int j = 0; j < carts.size(); ++j)
-				{
-					const Cart &cart2 = carts[j];
-					if (cart.pos.x == cart2.pos.x &&
-						cart.pos.y == cart2.pos.y &&
-						i != j)
-					{
-						state[cart2.pos.y * width + cart2.pos.x] = cart2.under;
-						if (i > j)
-							--i;
-						carts.erase(carts.begin() + j);
-						break;
-					}
-				}
-				carts.erase(carts.begin() + i);
-				--i;
+				carts[occupant].crashed = true;
+				cart.crashed = true;
+				occupant = -1;
+				remaining -= 2;
 
 				continue;
+			}
+			occupant = i;
 
-			case '/':
-				// track curve
-				switch (cart.dir)
-				{
-				case Direction::Up:		cart.dir = Direction::Right; break;
-				case Direction::Right:	cart.dir = Direction::Up; break;
-				case Direction::Down:	cart.dir = Direction::Left; break;
-				case Direction::Left:	cart.dir = Direction::Down; break;
-				}
-				break;
+			// update based on what's at the new position
+			Steer(cart.dir, cart.turn, track[cart.pos.y * width + cart.pos.x]);
+		}
 
-			case '\\':
-				// track curve
-				switch (cart.dir)
-				{
-				case Direction::Up:		cart.dir = Direction::Left; break;
-				case Direction::Right:	cart.dir = Direction::Down; break;
-				case Direction::Down:	cart.dir = Direction::Right; break;
-				case Direction::Left:	cart.dir = Direction::Up; break;
-				}
-				break;
+		// drop the crashed carts
+		carts.erase(std::remove_if(carts.begin(), carts.end(), [](Cart const &cart) { return cart.crashed; }), carts.end());
 
-			case '+':
-				// intersection
-				switch (cart.turn)
+		// stop when only one cart remains
+		if (remaining <= 1)
+		{
+			if (remaining == 0)
+				return false;
+			last = carts.back().pos;
+			return true;
+		}
+
+		// restore reading order for the next tick
+		// (carts that stayed in their row can't have passed each other without crashing, so they are still in order;
+		// only the carts that moved up or down need sorting and merging back in)
+		auto moved = std::stable_partition(carts.begin(), carts.end(), [](Cart const &cart) { return !cart.movedRow; });
+		std::sort(moved, carts.end());
+		std::inplace_merge(carts.begin(), moved, carts.end());
+
+		// update the occupancy for the new order
+		for (int i = 0; i < int(carts.size()); ++i)
+		{
+			occupancy[carts[i].pos.y * width + carts[i].pos.x] = i;
+		}
+	}
+}
+
+#ifdef EVENT_DRIVEN
+// track compiled into straight segments between curve and intersection cells ("nodes")
+// (segments are found the first time a cart travels them)
+struct TrackGraph
+{
+	std::string track;			// track layout with the carts removed
+	short width = 0;
+	short height = 0;
+	std::vector<int> nodeAt;	// node at each location (or -1 for straight track)
+	std::vector<Position> nodes;
+
+	// for each node and direction (node * 4 + direction):
+	std::vector<int> segments;	// segment leaving the node (or -1 if not found yet)
+	std::vector<int> lengths;	// steps to the next node
+	std::vector<int> targets;	// next node
+
+	int segmentCount = 0;
+};
+
+void BuildTrackGraph(TrackGraph &graph, std::string const &track, short width, short height)
+{
+	graph.track = track;
+	graph.width = width;
+	graph.height = height;
+	graph.nodeAt.assign(track.size(), -1);
+	for (int i = 0; i < int(track.size()); ++i)
+	{
+		if (track[i] == '/' || track[i] == '\\' || track[i] == '+')
+		{
+			graph.nodeAt[i] = int(graph.nodes.size());
+			graph.nodes.push_back({ short(i % width), short(i / width) });
+		}
+	}
+	graph.segments.assign(graph.nodes.size() * 4, -1);
+	graph.lengths.assign(graph.nodes.size() * 4, 0);
+	graph.targets.assign(graph.nodes.size() * 4, -1);
+}
+
+// get the segment leaving a node in a direction, following it to the next node if needed
+int GetSegment(TrackGraph &graph, int node, Direction dir)
+{
+	const int index = node * 4 + int(dir);
+	if (graph.segments[index] < 0)
+	{
+		// walk along the straight track
+		Position pos = graph.nodes[node];
+		int length = 0;
+		do
+		{
+			Move(pos, dir);
+			++length;
+			assert(pos.x >= 0 && pos.x < graph.width && pos.y >= 0 && pos.y < graph.height);
+			assert(graph.track[pos.y * graph.width + pos.x] != ' ');
+		} while (graph.nodeAt[pos.y * graph.width + pos.x] < 0);
+
+		// the same segment leads back the other way
+		const int target = graph.nodeAt[pos.y * graph.width + pos.x];
+		const int reverse = target * 4 + (int(dir) + 2) % int(Direction::Count);
+		graph.segments[index] = graph.segments[reverse] = graph.segmentCount++;
+		graph.lengths[index] = graph.lengths[reverse] = length;
+		graph.targets[index] = target;
+		graph.targets[reverse] = node;
+	}
+	return graph.segments[index];
+}
+
+// a cart's run along a segment to the next node
+struct Leg
+{
+	int start;		// tick at the start of the run
+	Position from;	// location at the start tick
+	Direction dir;
+	Turn turn;		// next turn direction
+	int length;		// steps to the next node
+	int target;		// next node
+	int segment;
+	int source;		// node the run starts from (or -1 for a cart that started on the segment)
+};
+
+// move a number of steps in a direction
+Position MoveBy(Position pos, Direction dir, int steps)
+{
+	static const int dx[] = { 0, 1, 0, -1 };
+	static const int dy[] = { -1, 0, 1, 0 };
+	return { short(pos.x + dx[int(dir)] * steps), short(pos.y + dy[int(dir)] * steps) };
+}
+
+// cart location at the start of a tick, up to the end of its leg
+Position GetPosition(Leg const &leg, int tick)
+{
+	assert(tick >= leg.start && tick <= leg.start + leg.length);
+	return MoveBy(leg.from, leg.dir, tick - leg.start);
+}
+
+// crash between two carts, or a cart reaching the end of its leg
+struct Event
+{
+	int tick;
+	int kind;		// 0: cart reaches a node, 1: crash
+	int order;		// reading order of the moving cart at the start of the tick
+	int cart;
+	int other;
+	Position pos;
+};
+
+bool operator>(Event const &a, Event const &b)
+{
+	if (a.tick != b.tick)
+		return a.tick > b.tick;
+	if (a.kind != b.kind)
+		return a.kind > b.kind;
+	return a.order > b.order;
+}
+
+// find the first step where the gap between two carts reaches a target, as it changes by a fixed amount each step
+// (or -1 if it doesn't within the given steps)
+int SolveGap(const int gap[2], const int change[2], const int target[2], int steps)
+{
+	int step = 0;
+	bool fixed = false;
+	for (int axis = 0; axis < 2; ++axis)
+	{
+		const int distance = target[axis] - gap[axis];
+		if (change[axis] == 0)
+		{
+			// this axis never changes, so it matches on every step or none
+			if (distance != 0)
+				return -1;
+			continue;
+		}
+		if (distance % change[axis] != 0 || distance / change[axis] < 0)
+			return -1;
+		if (fixed && distance / change[axis] != step)
+			return -1;
+		step = distance / change[axis];
+		fixed = true;
+	}
+	return step < steps ? step : -1;
+}
+
+// find the first collision between two carts running straight for a number of ticks
+// (the carts move one at a time in reading order, as in Simulate, so they crash when the first to move steps onto the other,
+// the second steps onto the first, or the second steps where the first just went; each of these is a fixed gap
+// between the carts, reached on at most one tick)
+bool FindCollision(Event &output, Position a, Direction dirA, int cartA, Position b, Direction dirB, int cartB, int tick, int ticks, short width)
+{
+	const Position stepA = MoveBy({}, dirA, 1);
+	const Position stepB = MoveBy({}, dirB, 1);
+	const int gap[2] = { b.x - a.x, b.y - a.y };
+	const int change[2] = { stepB.x - stepA.x, stepB.y - stepA.y };
+	const int targets[3][2] = {
+		{ stepA.x, stepA.y },						// a steps onto b
+		{ -stepB.x, -stepB.y },						// b steps onto a
+		{ stepA.x - stepB.x, stepA.y - stepB.y }	// both step to the same location
+	};
+
+	bool found = false;
+	for (int kind = 0; kind < 3; ++kind)
+	{
+		const int step = SolveGap(gap, change, targets[kind], ticks);
+		if (step < 0 || (found && tick + step >= output.tick))
+			continue;
+		if (targets[kind][0] == 0 && targets[kind][1] == 0)
+			continue;
+
+		// check the carts move in the right order
+		const Position posA = MoveBy(a, dirA, step);
+		const Position posB = MoveBy(b, dirB, step);
+		const bool aFirst = posA < posB;
+		if ((kind == 0 && !aFirst) || (kind == 1 && aFirst))
+			continue;
+
+		const bool aMoves = kind == 0 || (kind == 2 && !aFirst);
+		Position const &mover = aMoves ? posA : posB;
+		output = { tick + step, 1, mover.y * width + mover.x, aMoves ? cartA : cartB, aMoves ? cartB : cartA, aMoves ? posB : posA };
+		if (kind == 2)
+			output.pos = MoveBy(posA, dirA, 1);
+		found = true;
+	}
+	return found;
+}
+
+// simulate the carts a segment at a time, visiting only the ticks where a cart reaches a node or crashes
+// (otherwise the same as Simulate)
+bool SimulateEvents(std::string const &layout, short width, short height, CrashSink const &sink, Position &last)
+{
+	// cart locations
+	std::string track;
+	std::vector<Cart> carts;
+	ReadCarts(carts, track, layout, width);
+
+	TrackGraph graph;
+	BuildTrackGraph(graph, track, width, height);
+
+	std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+	std::vector<Leg> legs(carts.size());
+	std::vector<std::vector<int>> onSegment;	// carts on each segment
+	int remaining = int(carts.size());
+
+	// put a cart on a leg and queue its arrival at the next node
+	auto startLeg = [&](int cart, Leg const &leg)
+	{
+		legs[cart] = leg;
+		if (int(onSegment.size()) < graph.segmentCount)
+			onSegment.resize(graph.segmentCount);
+		onSegment[leg.segment].push_back(cart);
+		events.push({ leg.start + leg.length, 0, cart, cart, cart, graph.nodes[leg.target] });
+	};
+
+	// queue the first crash with each cart that can meet a leg while both keep running straight
+	// (only carts on the same segment, or at or next to either end of it, can reach its track; later ticks are checked
+	// when the other cart starts its next leg)
+	auto checkLeg = [&](int cart)
+	{
+		Leg const &leg = legs[cart];
+		for (int node : { leg.source, leg.target })
+		{
+			if (node < 0)
+				continue;
+			for (int dir = 0; dir < int(Direction::Count); ++dir)
+			{
+				const int segment = graph.segments[node * 4 + dir];
+				if (segment < 0 || segment >= int(onSegment.size()))
+					continue;
+				for (int other : onSegment[segment])
 				{
-				case Turn::Left:
-					cart.dir = Direction((int(cart.dir) + int(Direction::Count) - 1) % int(Direction::Count));
-					break;
-				case Turn::Right:
-					cart.dir = Direction((int(cart.dir) + 1) % int(Direction::Count));
-					break;
+					if (other == cart || carts[other].crashed)
+						continue;
+					Leg const &otherLeg = legs[other];
+					const int end = std::min(leg.start + leg.length, otherLeg.start + otherLeg.length);
+					Event crash;
+					if (FindCollision(crash, leg.from, leg.dir, cart, GetPosition(otherLeg, leg.start), otherLeg.dir, other, leg.start, end - leg.start, width))
+						events.push(crash);
 				}
-				cart.turn = Turn((int(cart.turn) + 1) % int(Turn::Count));
 			}
+		}
+	};
 
-			// save the track
-			cart.under = state[cart.pos.y * width + cart.pos.x];
+	// start every cart on the segment it was placed on
+	for (int i = 0; i < int(carts.size()); ++i)
+	{
+		Cart const &cart = carts[i];
+		assert(graph.nodeAt[cart.pos.y * width + cart.pos.x] < 0);
 
-			// place the cart
-			state[cart.pos.y * width + cart.pos.x] = image[int(cart.dir)];
-		}
+		// find the node behind the cart
+		const Direction back = Direction((int(cart.dir) + 2) % int(Direction::Count));
+		Position pos = cart.pos;
+		int behind = 0;
+		do
+		{
+			Move(pos, back);
+			++behind;
+		} while (graph.nodeAt[pos.y * width + pos.x] < 0);
+		const int source = graph.nodeAt[pos.y * width + pos.x];
+		const int segment = GetSegment(graph, source, cart.dir);
+		const int index = source * 4 + int(cart.dir);
 
-		// for part 2, stop when only one cart remains
-		if (part == 2 && carts.size() == 1)
+		startLeg(i, { 0, cart.pos, cart.dir, cart.turn, graph.lengths[index] - behind, graph.targets[index], segment, -1 });
+	}
+	for (int i = 0; i < int(carts.size()); ++i)
+	{
+		checkLeg(i);
+	}
+
+	// with at most one cart there is nothing to crash into
+	// (a lone cart still runs its first tick, as in Simulate)
+	if (remaining == 0)
+		return false;
+	if (remaining == 1)
+	{
+		last = GetPosition(legs[0], 1);
+		return true;
+	}
+
+	while (!events.empty())
+	{
+		const Event event = events.top();
+		events.pop();
+
+		if (event.kind == 0)
 		{
-			std::cout << "Part " << part << ": last cart at " << carts.back().pos.x << ", " << carts.back().pos.y << "\n";
-			return;
+			// a cart reached a node
+			if (carts[event.cart].crashed)
+				continue;
+			Leg &leg = legs[event.cart];
+			std::vector<int> &previous = onSegment[leg.segment];
+			previous.erase(std::find(previous.begin(), previous.end(), event.cart));
+
+			// turn onto the next segment
+			Direction dir = leg.dir;
+			Turn turn = leg.turn;
+			Steer(dir, turn, track[event.pos.y * width + event.pos.x]);
+			const int node = leg.target;
+			const int segment = GetSegment(graph, node, dir);
+			const int index = node * 4 + int(dir);
+
+			startLeg(event.cart, { event.tick, event.pos, dir, turn, graph.lengths[index], graph.targets[index], segment, node });
+			checkLeg(event.cart);
 		}
+		else
+		{
+			// two carts crashed
+			if (carts[event.cart].crashed || carts[event.other].crashed)
+				continue;
+			sink({ event.tick, event.pos, carts[event.cart].id, carts[event.other].id });
+
+			// remove the colliding carts
+			for (int cart : { event.cart, event.other })
+			{
+				carts[cart].crashed = true;
+				std::vector<int> &segment = onSegment[legs[cart].segment];
+				segment.erase(std::find(segment.begin(), segment.end(), cart));
+			}
+			remaining -= 2;
 
-		// sort the carts for the next tick
-		std::sort(carts.begin(), carts.end());
+			// stop when only one cart remains
+			// (reporting where it ends up after this tick)
+			if (remaining <= 1)
+			{
+				if (remaining == 0)
+					return false;
+				for (int i = 0; i < int(carts.size()); ++i)
+				{
+					if (!carts[i].crashed)
+					{
+						last = GetPosition(legs[i], event.tick + 1);
+						return true;
+					}
+				}
+			}
+		}
 	}
+
+	// every cart crashed
+	return false;
 }
+#endif
 
 int main()
 {
@@ -207,8 +584,28 @@ int main()
 		++height;
 	}
 
-	Simulate(layout, width, height, 1);
-	Simulate(layout, width, height, 2);
+	// log every crash, keeping the first
+	std::vector<Crash> crashes;
+	auto sink = [&crashes](Crash const &crash)
+	{
+		std::cout << "crash at " << crash.pos.x << ", " << crash.pos.y << " on tick " << crash.tick << " (carts " << crash.cart << " and " << crash.other << ")\n";
+		crashes.push_back(crash);
+	};
+
+	// run the carts once for both parts
+	Position last;
+#ifdef EVENT_DRIVEN
+	const bool found = SimulateEvents(layout, width, height, sink, last);
+#else
+	const bool found = Simulate(layout, width, height, sink, last);
+#endif
+
+	if (!crashes.empty())
+		std::cout << "Part 1: first crash at " << crashes.front().pos.x << ", " << crashes.front().pos.y << " on tick " << crashes.front().tick << "\n";
+	if (found)
+		std::cout << "Part 2: last cart at " << last.x << ", " << last.y << "\n";
+	else
+		std::cout << "Part 2: no carts remain\n";
 
 	return 0;
 }
\ No newline at end of file
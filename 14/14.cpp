@@ -1,107 +1,201 @@
 #include <iostream>
 #include <string>
+#include <vector>
+#include <cstdint>
 
 // https://adventofcode.com/2018/day/14
 
-// print the state in the format on the puzzle entry page
-void PrintState(std::string const &state, int index1, int index2)
+// move an elf forward through the scoreboard
+// (the step is at most 10, so wrapping around never needs a division)
+inline size_t Advance(size_t index, size_t step, size_t count)
 {
-	for (int i = 0; i < state.size(); ++i)
-	{
-		if (i == index1)
-		{
-			std::cout << "(" << state[i] << ")";
-		}
-		else if (i == index2)
-		{
-			std::cout << "[" << state[i] << "]";
-		}
-		else
-		{
-			std::cout << " " << state[i] << " ";
-		}
-	}
-	std::cout << "\n";
+	index += step;
+	while (index >= count)
+		index -= count;
+	return index;
 }
 
-// PART 1
-void Part1(int count)
+// recipe scores, one digit per entry, generated on demand
+// (recipes generated for one query are kept for the next)
+class Scoreboard
 {
-	// run until the state length is count + 10
-	std::string state = "37";
-	int index1 = 0, index2 = 1;
-	for(;;)
+public:
+	Scoreboard()
+		: scores(1 << 24)
+	{
+		scores[0] = 3;
+		scores[1] = 7;
+	}
+
+	// make sure at least count recipes have been generated
+	void Extend(size_t count)
+	{
+		while (length < count)
+			Step();
+	}
+
+	// number of recipes generated so far
+	size_t Size() const
+	{
+		return length;
+	}
+
+	// score of a generated recipe
+	uint8_t operator[](size_t index) const
 	{
-		int score1 = state[index1] - '0';
-		int score2 = state[index2] - '0';
+		return scores[index];
+	}
+
+	// get the next recipe after the ones generated so far
+	void Step()
+	{
+		// the scoreboard doubles in size when full, which only happens a few times
+		if (length + 2 > scores.size())
+			scores.resize(scores.size() * 2);
+
+		int score1 = scores[index1];
+		int score2 = scores[index2];
 		int sum = score1 + score2;
 		if (sum >= 10)
 		{
-			state.push_back('0' + sum / 10);
-			if (state.length() >= count + 10)
-				break;
-			state.push_back('0' + sum % 10);
+			scores[length++] = uint8_t(sum / 10);
+			scores[length++] = uint8_t(sum % 10);
 		}
 		else
 		{
-			state.push_back('0' + sum);
+			scores[length++] = uint8_t(sum);
 		}
-		if (state.length() >= count + 10)
-			break;
-		index1 = (index1 + score1 + 1) % state.size();
-		index2 = (index2 + score2 + 1) % state.size();
+		index1 = Advance(index1, score1 + 1, length);
+		index2 = Advance(index2, score2 + 1, length);
 	}
 
-	// print out the last 10 values
-	std::cout << "Part 1: next " << state.substr(count, 10) << "\n";
-}
+	// print the state in the format on the puzzle entry page
+	void Print() const
+	{
+		for (size_t i = 0; i < length; ++i)
+		{
+			if (i == index1)
+			{
+				std::cout << "(" << int(scores[i]) << ")";
+			}
+			else if (i == index2)
+			{
+				std::cout << "[" << int(scores[i]) << "]";
+			}
+			else
+			{
+				std::cout << " " << int(scores[i]) << " ";
+			}
+		}
+		std::cout << "\n";
+	}
+
+private:
+	std::vector<uint8_t> scores;	// preallocated storage
+	size_t length = 2;				// recipes generated so far
+	size_t index1 = 0, index2 = 1;	// current recipe of each elf
+};
 
-// check if the end of the state matches the pattern
-bool Match(std::string const &state, std::string const &pattern)
+// recent digits packed four bits each, most recent lowest
+// (holds up to 16 digits, so appending a digit and comparing against the pattern are single operations)
+struct RollingDigits
 {
-	return state.length() >= pattern.length() && state.substr(state.length() - pattern.length()) == pattern;
-}
+	uint64_t digits = 0;
+	uint64_t mask = 0;
 
-// PART 2
-void Part2(std::string const &pattern)
+	explicit RollingDigits(size_t length)
+		: mask(length >= 16 ? ~uint64_t(0) : (uint64_t(1) << (length * 4)) - 1)
+	{
+	}
+
+	// add a digit, dropping the oldest one
+	void Push(uint8_t digit)
+	{
+		digits = ((digits << 4) | digit) & mask;
+	}
+};
+
+// find where a pattern of digits first appears
+// (scans the recipes generated so far before generating more)
+size_t Find(Scoreboard &scoreboard, std::string const &pattern)
 {
-	// run until the specified pattern appears
-	std::string state = "37";
-	int index1 = 0, index2 = 1;
-	for (;;)
+	// patterns too long to pack compare the most recent recipes directly
+	if (pattern.length() > 16)
 	{
-		int score1 = state[index1] - '0';
-		int score2 = state[index2] - '0';
-		int sum = score1 + score2;
-		if (sum >= 10)
+		for (size_t i = 0; ; ++i)
 		{
-			state.push_back('0' + sum / 10);
-			if (Match(state, pattern))
-				break;
-			state.push_back('0' + sum % 10);
+			if (i == scoreboard.Size())
+				scoreboard.Step();
+			if (i + 1 < pattern.length())
+				continue;
+			size_t start = i + 1 - pattern.length();
+			size_t j = 0;
+			while (j < pattern.length() && scoreboard[start + j] == uint8_t(pattern[j] - '0'))
+				++j;
+			if (j == pattern.length())
+				return start;
 		}
-		else
-		{
-			state.push_back('0' + sum);
-		}
-		if (Match(state, pattern))
-			break;
-		index1 = (index1 + score1 + 1) % state.size();
-		index2 = (index2 + score2 + 1) % state.size();
 	}
 
+	// pack the pattern the same way as the recent digits
+	RollingDigits target(pattern.length());
+	for (char const c : pattern)
+	{
+		target.Push(uint8_t(c - '0'));
+	}
+
+	RollingDigits recent(pattern.length());
+	for (size_t i = 0; ; ++i)
+	{
+		if (i == scoreboard.Size())
+			scoreboard.Step();
+		recent.Push(scoreboard[i]);
+		if (i + 1 >= pattern.length() && recent.digits == target.digits)
+			return i + 1 - pattern.length();
+	}
+}
+
+// PART 1
+void Part1(Scoreboard &scoreboard, int count)
+{
+	// make sure there are 10 recipes after count
+	scoreboard.Extend(count + 10);
+
+	// print out those 10 values
+	std::cout << "Part 1: next ";
+	for (int i = 0; i < 10; ++i)
+	{
+		std::cout << int(scoreboard[count + i]);
+	}
+	std::cout << "\n";
+}
+
+// PART 2
+void Part2(Scoreboard &scoreboard, std::string const &pattern)
+{
 	// print the number of entries leading up to the pattern
-	std::cout << "Part 1: pattern appears at " << state.length() - pattern.length() << "\n";
+	std::cout << "Part 2: pattern appears at " << Find(scoreboard, pattern) << "\n";
 }
 
 int main()
 {
-	// get the input value
+	// get the input values
+	std::vector<std::string> inputs;
 	std::string input;
-	std::cin >> input;
+	while (std::cin >> input)
+	{
+		inputs.push_back(input);
+	}
 
-	Part1(atoi(input.c_str()));
-	Part2(input);
+	// answer every input from the same scoreboard
+	Scoreboard scoreboard;
+	for (std::string const &input : inputs)
+	{
+		if (inputs.size() > 1)
+			std::cout << "Input " << input << "\n";
+		Part1(scoreboard, atoi(input.c_str()));
+		Part2(scoreboard, input);
+	}
 
 	return 0;
 }
\ No newline at end of file
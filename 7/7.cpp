@@ -73,6 +73,15 @@ void Part1(std::vector<Constraint> const &constraints)
 	std::cout << "Part 1: instruction order " << order << "\n";
 }
 
+// time to complete a step
+int GetStepTime(int step)
+{
+	return 61 + step;
+}
+
+// number of available workers
+const int maxWorkers = 5;
+
 struct Worker
 {
 	int time = 0;
@@ -91,7 +100,7 @@ bool operator<(Worker const &a, Worker const &b)
 }
 
 // PART 2
-void Part2(std::vector<Constraint> const &constraints)
+int Part2(std::vector<Constraint> const &constraints)
 {
 	// convert the array of constraints into an array of bit masks
 	// representing what steps become available upon completing that step
@@ -105,7 +114,6 @@ void Part2(std::vector<Constraint> const &constraints)
 	}
 
 	// worker pool
-	const int maxWorkers = 5;
 	std::vector<Worker> activeWorkers;
 	int completedTime = 0;
 
@@ -140,7 +148,7 @@ void Part2(std::vector<Constraint> const &constraints)
 				// add the worker
 				Worker worker;
 				worker.task = i;
-				worker.time = completedTime + (61 + i);
+				worker.time = completedTime + GetStepTime(i);
 				activeWorkers.push_back(worker);
 				std::push_heap(activeWorkers.begin(), activeWorkers.end());
 			}
@@ -164,6 +172,103 @@ void Part2(std::vector<Constraint> const &constraints)
 	}
 
 	std::cout << "Part 2: time to complete is " << completedTime << "\n";
+
+	return completedTime;
+}
+
+// ANALYSIS
+// compare the scheduled time against the theoretical lower bounds
+void Analyze(std::vector<Constraint> const &constraints, int scheduledTime)
+{
+	// count the prerequisites of each step
+	int prerequisiteCount[26] = { 0 };
+	unsigned int stepsPossible = 0U;
+	for (Constraint const &constraint : constraints)
+	{
+		++prerequisiteCount[constraint.second - 'A'];
+		stepsPossible |= 1 << (constraint.first - 'A');
+		stepsPossible |= 1 << (constraint.second - 'A');
+	}
+
+	// start with the steps that have no prerequisites
+	std::vector<int> order;
+	for (int i = 0; i < 26; ++i)
+	{
+		if ((stepsPossible & (1 << i)) != 0 && prerequisiteCount[i] == 0)
+			order.push_back(i);
+	}
+
+	// earliest time each step could finish with unlimited workers
+	// and the prerequisite that determines it
+	int finishTime[26] = { 0 };
+	int criticalPrerequisite[26];
+	std::fill(std::begin(criticalPrerequisite), std::end(criticalPrerequisite), -1);
+
+	// visit steps in topological order; a step's earliest start
+	// is final by the time its last prerequisite is visited
+	for (size_t index = 0; index < order.size(); ++index)
+	{
+		int step = order[index];
+		finishTime[step] += GetStepTime(step);
+
+		for (Constraint const &constraint : constraints)
+		{
+			if (constraint.first - 'A' != step)
+				continue;
+
+			int next = constraint.second - 'A';
+			if (finishTime[next] < finishTime[step])
+			{
+				finishTime[next] = finishTime[step];
+				criticalPrerequisite[next] = step;
+			}
+			if (--prerequisiteCount[next] == 0)
+				order.push_back(next);
+		}
+	}
+
+	// every step gets visited unless the constraints contain a cycle
+	size_t stepCount = 0;
+	for (int i = 0; i < 26; ++i)
+	{
+		stepCount += (stepsPossible >> i) & 1;
+	}
+	assert(order.size() == stepCount);
+
+	// the critical path ends at the step that finishes last
+	int criticalTime = 0;
+	int lastStep = -1;
+	int totalWork = 0;
+	for (int step : order)
+	{
+		totalWork += GetStepTime(step);
+		if (criticalTime < finishTime[step])
+		{
+			criticalTime = finishTime[step];
+			lastStep = step;
+		}
+	}
+
+	// walk back along the critical path
+	std::string criticalPath;
+	for (int step = lastStep; step >= 0; step = criticalPrerequisite[step])
+	{
+		criticalPath.push_back(step + 'A');
+	}
+	std::reverse(criticalPath.begin(), criticalPath.end());
+
+	// no schedule can do better than the work spread evenly across all workers
+	int resourceTime = (totalWork + maxWorkers - 1) / maxWorkers;
+	int lowerBound = std::max(criticalTime, resourceTime);
+
+	std::cout << "Analysis: critical path " << criticalPath << " takes " << criticalTime << "\n";
+	std::cout << "Analysis: total work " << totalWork << " across " << maxWorkers << " workers takes at least " << resourceTime << "\n";
+	std::cout << "Analysis: schedule is " << scheduledTime - criticalTime << " over the critical path and " << scheduledTime - resourceTime << " over the resource bound\n";
+	std::cout << "Analysis: schedule is " << scheduledTime - lowerBound << " over the lower bound of " << lowerBound << "\n";
+	if (scheduledTime == criticalTime)
+		std::cout << "Analysis: schedule is limited by the critical path; more workers would not help\n";
+	else
+		std::cout << "Analysis: schedule is not limited by the critical path; more workers may help\n";
 }
 
 int main()
@@ -173,7 +278,8 @@ int main()
 	ReadConstraints(constraints, std::cin);
 
 	Part1(constraints);
-	Part2(constraints);
+	int scheduledTime = Part2(constraints);
+	Analyze(constraints, scheduledTime);
 
 	return 0;
 }
\ No newline at end of file
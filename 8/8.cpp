@@ -1,114 +1,382 @@
 #include <iostream>
+#include <sstream>
 #include <vector>
+#include <string>
+#include <iterator>
+#include <chrono>
 
 // https://adventofcode.com/2018/day/8
 
+// compute the answers while reading the input instead of building the tree
+//#define STREAMING
+
+// compare reading speed of the block reader against iostream
+//#define BENCHMARK
+
+// reads unsigned integers from an input stream in large blocks
+// (avoids the per-number locale and sentry overhead of operator>> on the stream)
+class NumberReader
+{
+public:
+	explicit NumberReader(std::istream &input, size_t blockSize = 1 << 16)
+		: input(input)
+		, buffer(blockSize + 1)
+	{
+		Refill();
+	}
+
+	// read the next number (or zero at the end of the input)
+	NumberReader &operator>>(int &value)
+	{
+		// skip separators
+		for (;;)
+		{
+			while (cursor != end && unsigned(*cursor - '0') >= 10)
+				++cursor;
+			if (cursor != end)
+				break;
+			if (!Refill())
+			{
+				value = 0;
+				return *this;
+			}
+		}
+
+		// accumulate digits
+		// (the sentinel after the buffered data is not a digit, so the inner loop needs no bounds check)
+		unsigned int result = 0;
+		for (;;)
+		{
+			unsigned int digit = unsigned(*cursor - '0');
+			while (digit < 10)
+			{
+				result = result * 10 + digit;
+				digit = unsigned(*++cursor - '0');
+			}
+			if (cursor != end || !Refill())
+				break;
+		}
+
+		value = int(result);
+		return *this;
+	}
+
+	// total number of bytes read from the input
+	size_t BytesRead() const
+	{
+		return bytesRead;
+	}
+
+private:
+	// read the next block from the input
+	bool Refill()
+	{
+		input.read(buffer.data(), buffer.size() - 1);
+		size_t count = size_t(input.gcount());
+		bytesRead += count;
+		cursor = buffer.data();
+		end = buffer.data() + count;
+		*end = '\0';
+		return count > 0;
+	}
+
+	std::istream &input;
+	std::vector<char> buffer;
+	char const *cursor = nullptr;
+	char *end = nullptr;
+	size_t bytesRead = 0;
+};
+
 // tree node
+// (nodes are stored in a flat array in pre-order, so a node's children always follow it)
 struct Node
 {
-	std::vector<std::unique_ptr<Node>> childNodes;
-	std::vector<int> metadataEntries;
+	int childCount = 0;
+	int firstChild = 0;		// index of the first child node index in the tree's child pool
+	int metadataCount = 0;
+	int firstMetadata = 0;	// index of the first metadata entry in the tree's metadata pool
 };
 
-// read in the tree nodes
-void ReadTree(Node &output, std::istream &input)
+// tree of nodes
+struct Tree
+{
+	std::vector<Node> nodes;
+	std::vector<int> childNodes;		// node index of each child, grouped by parent
+	std::vector<int> metadataEntries;	// metadata entries, grouped by node
+};
+
+// add a node to the tree, reading its header from the input
+template <typename Input>
+int AddNode(Tree &tree, Input &input)
 {
+	Node node;
+
 	// get number of child nodes
-	int numChildNodes;
-	input >> numChildNodes;
-	output.childNodes.resize(numChildNodes);
+	input >> node.childCount;
 
 	// get number of metadata entries
-	int numMetadataEntries;
-	input >> numMetadataEntries;
-	output.metadataEntries.resize(numMetadataEntries);
-
-	// recursively read in the child nodes
-	for (std::unique_ptr<Node> &childNode : output.childNodes)
-	{ 
-		childNode = std::make_unique<Node>();
-		ReadTree(*childNode, input);
-	}
+	input >> node.metadataCount;
+
+	// reserve space for the child node indices
+	node.firstChild = int(tree.childNodes.size());
+	tree.childNodes.resize(tree.childNodes.size() + node.childCount);
 
-	// read in the metadata entries
-	for (int &metadataEntry : output.metadataEntries)
+	tree.nodes.push_back(node);
+	return int(tree.nodes.size()) - 1;
+}
+
+// read in the tree nodes
+template <typename Input>
+void ReadTree(Tree &output, Input &input)
+{
+	output.nodes.clear();
+	output.childNodes.clear();
+	output.metadataEntries.clear();
+
+	// nodes that are still reading in their children
+	struct OpenNode
 	{
-		input >> metadataEntry;
+		int index;
+		int childrenRead;
+	};
+	std::vector<OpenNode> stack;
+
+	// start with the root node
+	stack.push_back({ AddNode(output, input), 0 });
+
+	while (!stack.empty())
+	{
+		OpenNode &open = stack.back();
+		Node const &node = output.nodes[open.index];
+
+		if (open.childrenRead < node.childCount)
+		{
+			// read in the next child node
+			int childIndex = AddNode(output, input);
+			output.childNodes[output.nodes[open.index].firstChild + open.childrenRead] = childIndex;
+			++open.childrenRead;
+			stack.push_back({ childIndex, 0 });
+		}
+		else
+		{
+			// read in the metadata entries
+			output.nodes[open.index].firstMetadata = int(output.metadataEntries.size());
+			for (int i = 0; i < node.metadataCount; ++i)
+			{
+				int metadataEntry;
+				input >> metadataEntry;
+				output.metadataEntries.push_back(metadataEntry);
+			}
+
+			// the node is complete
+			stack.pop_back();
+		}
 	}
 }
 
-// recursively sum the metadata entries for a node and all it children
-int GetSumOfMetadataEntries(Node const &node)
+// sum the metadata entries for all nodes
+int GetSumOfMetadataEntries(Tree const &tree)
 {
 	int sum = 0;
 
-	// add the metadata entries for this node
-	for (int metadataEntry : node.metadataEntries)
+	// metadata entries for all nodes are stored together
+	for (int metadataEntry : tree.metadataEntries)
 	{
 		sum += metadataEntry;
 	}
 
-	// add the sum from each child node
-	for (std::unique_ptr<Node> const &childNode : node.childNodes)
-	{
-		sum += GetSumOfMetadataEntries(*childNode);
-	}
-
 	return sum;
 }
 
 // PART 1
-void Part1(Node const &root)
+void Part1(Tree const &tree)
 {
-	int sum = GetSumOfMetadataEntries(root);
+	int sum = GetSumOfMetadataEntries(tree);
 	std::cout << "Part 1: sum of metadata entries is " << sum << "\n";
 }
 
-// get the value of a node
-int GetNodeValue(Node const &node)
+// get the value of every node
+// (nodes are stored in pre-order, so visiting them in reverse order
+// evaluates every child before its parent and each node only once)
+void GetNodeValues(std::vector<int> &values, Tree const &tree)
 {
-	int value = 0;
+	values.resize(tree.nodes.size());
 
-	if (node.childNodes.size() == 0)
+	for (int index = int(tree.nodes.size()) - 1; index >= 0; --index)
 	{
-		// node has no children:
-		// its value is the sum of its metadata entries
-		for (int metadataEntry : node.metadataEntries)
+		Node const &node = tree.nodes[index];
+		int const *metadataEntries = tree.metadataEntries.data() + node.firstMetadata;
+		int const *childNodes = tree.childNodes.data() + node.firstChild;
+
+		int value = 0;
+
+		if (node.childCount == 0)
 		{
-			value += metadataEntry;
+			// node has no children:
+			// its value is the sum of its metadata entries
+			for (int i = 0; i < node.metadataCount; ++i)
+			{
+				value += metadataEntries[i];
+			}
 		}
-	}
-	else
-	{
-		// node has children:
-		// its value is the sum of the values of the child nodes indexed by the metadata entries
-		for (int metadataEntry : node.metadataEntries)
+		else
 		{
-			if (metadataEntry > 0 && metadataEntry <= node.childNodes.size())
+			// node has children:
+			// its value is the sum of the values of the child nodes indexed by the metadata entries
+			for (int i = 0; i < node.metadataCount; ++i)
 			{
-				value += GetNodeValue(*node.childNodes[metadataEntry - 1]);
+				int metadataEntry = metadataEntries[i];
+				if (metadataEntry > 0 && metadataEntry <= node.childCount)
+				{
+					value += values[childNodes[metadataEntry - 1]];
+				}
 			}
 		}
-	}
 
-	return value;
+		values[index] = value;
+	}
 }
 
 // PART 2
-void Part2(Node const &root)
+void Part2(Tree const &tree)
 {
-	int value = GetNodeValue(root);
+	std::vector<int> values;
+	GetNodeValues(values, tree);
+	int value = values[0];
 	std::cout << "Part 2: value of the root node is " << value << "\n";
 }
 
+// compute the sum of metadata entries and the root node value while reading in the tree nodes
+// (only nodes still reading in their children are kept, each with the values of its finished children)
+template <typename Input>
+void ReadAndEvaluate(int &sum, int &rootValue, Input &input)
+{
+	sum = 0;
+	rootValue = 0;
+
+	// nodes that are still reading in their children
+	// (entries are reused so their child value storage is only allocated once per depth)
+	struct OpenNode
+	{
+		int childCount;
+		int metadataCount;
+		std::vector<int> childValues;
+	};
+	std::vector<OpenNode> stack(1);
+
+	// start with the root node
+	input >> stack[0].childCount >> stack[0].metadataCount;
+	size_t depth = 1;
+
+	while (depth > 0)
+	{
+		OpenNode &open = stack[depth - 1];
+
+		if (int(open.childValues.size()) < open.childCount)
+		{
+			// read in the next child node
+			if (depth == stack.size())
+				stack.emplace_back();
+			OpenNode &child = stack[depth];
+			input >> child.childCount >> child.metadataCount;
+			child.childValues.clear();
+			++depth;
+		}
+		else
+		{
+			// read in the metadata entries and compute the node value
+			int value = 0;
+			for (int i = 0; i < open.metadataCount; ++i)
+			{
+				int metadataEntry;
+				input >> metadataEntry;
+				sum += metadataEntry;
+
+				if (open.childCount == 0)
+				{
+					// node has no children:
+					// its value is the sum of its metadata entries
+					value += metadataEntry;
+				}
+				else if (metadataEntry > 0 && metadataEntry <= open.childCount)
+				{
+					// node has children:
+					// its value is the sum of the values of the child nodes indexed by the metadata entries
+					value += open.childValues[metadataEntry - 1];
+				}
+			}
+
+			// the node is complete; pass its value to the parent
+			--depth;
+			if (depth > 0)
+				stack[depth - 1].childValues.push_back(value);
+			else
+				rootValue = value;
+		}
+	}
+}
+
+#ifdef BENCHMARK
+// compare the time to read in the tree nodes using iostream and the block reader
+void Benchmark(std::string const &text)
+{
+	const int repeats = 10;
+	const double megabytes = text.size() / (1024.0 * 1024.0);
+	Tree tree;
+
+	// read each number with operator>> on the stream
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	for (int repeat = 0; repeat < repeats; ++repeat)
+	{
+		std::istringstream input(text);
+		ReadTree(tree, input);
+	}
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+	int streamSum = GetSumOfMetadataEntries(tree);
+	float streamTime = std::chrono::duration<float>(t2 - t1).count() / repeats;
+
+	// read the stream in blocks and parse the numbers from the buffer
+	t1 = std::chrono::high_resolution_clock::now();
+	for (int repeat = 0; repeat < repeats; ++repeat)
+	{
+		std::istringstream input(text);
+		NumberReader reader(input);
+		ReadTree(tree, reader);
+	}
+	t2 = std::chrono::high_resolution_clock::now();
+	int readerSum = GetSumOfMetadataEntries(tree);
+	float readerTime = std::chrono::duration<float>(t2 - t1).count() / repeats;
+
+	std::cout << "iostream: " << megabytes / streamTime << " MB/s [" << streamTime << "]\n";
+	std::cout << "block reader: " << megabytes / readerTime << " MB/s [" << readerTime << "]\n";
+	if (streamSum != readerSum)
+		std::cout << "mismatch: iostream sum " << streamSum << " block reader sum " << readerSum << "\n";
+}
+#endif
+
 int main()
 {
+#if defined(BENCHMARK)
+	// read in the whole input so both readers see the same data
+	std::string text((std::istreambuf_iterator<char>(std::cin)), std::istreambuf_iterator<char>());
+	Benchmark(text);
+#elif defined(STREAMING)
+	// read in the tree nodes and evaluate them on the fly
+	NumberReader reader(std::cin);
+	int sum, rootValue;
+	ReadAndEvaluate(sum, rootValue, reader);
+
+	std::cout << "Part 1: sum of metadata entries is " << sum << "\n";
+	std::cout << "Part 2: value of the root node is " << rootValue << "\n";
+#else
 	// read in the tree nodes
-	Node root;
-	ReadTree(root, std::cin);
+	NumberReader reader(std::cin);
+	Tree tree;
+	ReadTree(tree, reader);
 
-	Part1(root);
-	Part2(root);
+	Part1(tree);
+	Part2(tree);
+#endif
 
 	return 0;
 }
\ No newline at end of file
@@ -1,89 +1,628 @@
 #include <iostream>
 #include <vector>
-#include <list>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <numeric>
+#include <fstream>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
 
 // https://adventofcode.com/2018/day/9
 
-void Part(int partNumber, int playerCount, int lastMarbleWorth)
+// time both circle implementations across a range of game sizes
+//#define BENCHMARK
+
+// play every game listed in the input concurrently
+//#define BATCH
+
+// play a long game in stages, reporting the standings and saving a checkpoint after each one
+// (only the latest checkpoint is kept, and a run picks it up if an earlier run with the same player count left it)
+//#define CHECKPOINT
+#ifdef CHECKPOINT
+const int CHECKPOINT_INTERVAL = 1000000;
+const int CHECKPOINT_SCALE = 1000;
+const char CHECKPOINT_PATH[] = "9.checkpoint";
+#endif
+
+// the circle of marbles;
+// the clockwise and counter-clockwise neighbors of each marble are stored in arrays
+// indexed by marble value (values are unique), so unlike a linked list it needs
+// no allocation per marble and insert and erase are still O(1)
+class LinkedMarbleCircle
+{
+public:
+	// start with only the 0 marble, with room for marbles up to the last one
+	void Reset(uint32_t lastMarble)
+	{
+		next.resize(lastMarble + 1);
+		prev.resize(lastMarble + 1);
+		next[0] = 0;
+		prev[0] = 0;
+		current = 0;
+	}
+
+	// insert the marble between the 1st and 2nd marble clockwise
+	// from the current marble and make it the new current marble
+	void Insert(uint32_t marble)
+	{
+		uint32_t before = next[current];
+		uint32_t after = next[before];
+		next[before] = marble;
+		prev[marble] = before;
+		next[marble] = after;
+		prev[after] = marble;
+		current = marble;
+	}
+
+	// remove the marble 7 places counter-clockwise from the current marble
+	// and make its clockwise neighbor current
+	uint32_t Remove()
+	{
+		uint32_t marble = current;
+		for (int i = 0; i < 7; ++i)
+		{
+			marble = prev[marble];
+		}
+		uint32_t before = prev[marble];
+		uint32_t after = next[marble];
+		next[before] = after;
+		prev[after] = before;
+		current = after;
+		return marble;
+	}
+
+private:
+	std::vector<uint32_t> next;
+	std::vector<uint32_t> prev;
+	uint32_t current = 0;
+};
+
+// the circle of marbles;
+// stored in order as a circular list of fixed-size blocks so memory grows with
+// the number of marbles actually in the circle (about 4-8 bytes each) instead of
+// with the value of the last marble, and blocks are reused between games
+class BlockMarbleCircle
+{
+public:
+	static const uint32_t BLOCK_SIZE = 256;
+
+	// start with only the 0 marble
+	// (blocks are allocated as the circle grows, so the last marble is not needed)
+	void Reset(uint32_t /*lastMarble*/)
+	{
+		// return all blocks to the free list
+		freeBlocks.clear();
+		for (uint32_t index = uint32_t(blocks.size()); index > 0; --index)
+		{
+			freeBlocks.push_back(index - 1);
+		}
+
+		// place the 0 marble in a block by itself
+		currentBlock = AllocateBlock();
+		Block &block = *blocks[currentBlock];
+		block.next = currentBlock;
+		block.prev = currentBlock;
+		block.count = 1;
+		block.marbles[0] = 0;
+		currentOffset = 0;
+	}
+
+	// insert the marble between the 1st and 2nd marble clockwise
+	// from the current marble and make it the new current marble
+	void Insert(uint32_t marble)
+	{
+		// step to the 1st marble clockwise and insert after it
+		Rotate(1);
+		++currentOffset;
+
+		// split the block if it is full
+		// (the insertion point sweeps clockwise through the circle, so splitting there
+		// leaves a nearly full block behind instead of two half-full ones)
+		if (blocks[currentBlock]->count == BLOCK_SIZE)
+		{
+			uint32_t splitOffset = std::max(currentOffset, BLOCK_SIZE / 2);
+			Split(currentBlock, splitOffset);
+			if (currentOffset >= splitOffset)
+			{
+				currentOffset -= splitOffset;
+				currentBlock = blocks[currentBlock]->next;
+			}
+		}
+
+		// open a space for the marble
+		Block &block = *blocks[currentBlock];
+		memmove(&block.marbles[currentOffset + 1], &block.marbles[currentOffset], (block.count - currentOffset) * sizeof(uint32_t));
+		block.marbles[currentOffset] = marble;
+		++block.count;
+	}
+
+	// remove the marble 7 places counter-clockwise from the current marble
+	// and make its clockwise neighbor current
+	uint32_t Remove()
+	{
+		Rotate(-7);
+
+		// close up the space left by the marble
+		Block &block = *blocks[currentBlock];
+		uint32_t marble = block.marbles[currentOffset];
+		memmove(&block.marbles[currentOffset], &block.marbles[currentOffset + 1], (block.count - currentOffset - 1) * sizeof(uint32_t));
+		--block.count;
+
+		// merge a sparse block with its clockwise neighbor
+		if (block.count < BLOCK_SIZE / 4 && block.next != currentBlock && block.count + blocks[block.next]->count <= BLOCK_SIZE / 2)
+		{
+			uint32_t nextIndex = block.next;
+			Block const &next = *blocks[nextIndex];
+			memcpy(&block.marbles[block.count], &next.marbles[0], next.count * sizeof(uint32_t));
+			block.count += next.count;
+			Unlink(nextIndex);
+		}
+
+		// the clockwise neighbor may be in the next block
+		if (currentOffset == block.count)
+		{
+			uint32_t emptyIndex = currentBlock;
+			currentBlock = block.next;
+			currentOffset = 0;
+			if (block.count == 0)
+			{
+				assert(currentBlock != emptyIndex);
+				Unlink(emptyIndex);
+			}
+		}
+
+		return marble;
+	}
+
+	// get the marbles in clockwise order starting from the current marble
+	void Save(std::vector<uint32_t> &marbles) const
+	{
+		marbles.clear();
+		uint32_t index = currentBlock;
+		uint32_t offset = currentOffset;
+		do
+		{
+			Block const &block = *blocks[index];
+			marbles.insert(marbles.end(), &block.marbles[offset], &block.marbles[block.count]);
+			index = block.next;
+			offset = 0;
+		}
+		while (index != currentBlock);
+		marbles.insert(marbles.end(), &blocks[currentBlock]->marbles[0], &blocks[currentBlock]->marbles[currentOffset]);
+	}
+
+	// replace the circle with marbles in clockwise order starting from the current marble
+	void Load(std::vector<uint32_t> const &marbles)
+	{
+		assert(!marbles.empty());
+		Reset(0);
+
+		// fill blocks three quarters full to leave room for insertions
+		const uint32_t fill = BLOCK_SIZE * 3 / 4;
+		Block &first = *blocks[currentBlock];
+		first.count = 0;
+		uint32_t lastIndex = currentBlock;
+		for (size_t start = 0; start < marbles.size(); start += fill)
+		{
+			uint32_t index = lastIndex;
+			if (start > 0)
+			{
+				index = AllocateBlock();
+				Block &block = *blocks[index];
+				block.prev = lastIndex;
+				block.next = currentBlock;
+				blocks[lastIndex]->next = index;
+				blocks[currentBlock]->prev = index;
+			}
+			Block &block = *blocks[index];
+			block.count = uint32_t(std::min(size_t(fill), marbles.size() - start));
+			memcpy(&block.marbles[0], &marbles[start], block.count * sizeof(uint32_t));
+			lastIndex = index;
+		}
+		currentOffset = 0;
+	}
+
+	// bytes of block storage allocated
+	size_t MemoryUsed() const
+	{
+		return blocks.size() * sizeof(Block);
+	}
+
+private:
+	struct Block
+	{
+		uint32_t next;	// clockwise neighbor block
+		uint32_t prev;	// counter-clockwise neighbor block
+		uint32_t count;
+		uint32_t marbles[BLOCK_SIZE];
+	};
+
+	// move the current marble k places clockwise (or counter-clockwise if negative)
+	// (blocks never stay empty, so this takes O(1) steps for small k)
+	void Rotate(int k)
+	{
+		int offset = int(currentOffset) + k;
+		while (offset >= int(blocks[currentBlock]->count))
+		{
+			offset -= blocks[currentBlock]->count;
+			currentBlock = blocks[currentBlock]->next;
+		}
+		while (offset < 0)
+		{
+			currentBlock = blocks[currentBlock]->prev;
+			offset += blocks[currentBlock]->count;
+		}
+		currentOffset = uint32_t(offset);
+	}
+
+	// get an unused block
+	uint32_t AllocateBlock()
+	{
+		if (freeBlocks.empty())
+		{
+			blocks.push_back(std::make_unique<Block>());
+			return uint32_t(blocks.size()) - 1;
+		}
+		uint32_t index = freeBlocks.back();
+		freeBlocks.pop_back();
+		return index;
+	}
+
+	// move the marbles from the offset onward into a new block after it
+	void Split(uint32_t index, uint32_t offset)
+	{
+		uint32_t splitIndex = AllocateBlock();
+		Block &block = *blocks[index];
+		Block &split = *blocks[splitIndex];
+		split.count = block.count - offset;
+		block.count = offset;
+		memcpy(&split.marbles[0], &block.marbles[offset], split.count * sizeof(uint32_t));
+
+		split.prev = index;
+		split.next = block.next;
+		blocks[block.next]->prev = splitIndex;
+		block.next = splitIndex;
+	}
+
+	// remove a block from the circle and return it to the free list
+	void Unlink(uint32_t index)
+	{
+		Block const &block = *blocks[index];
+		blocks[block.prev]->next = block.next;
+		blocks[block.next]->prev = block.prev;
+		freeBlocks.push_back(index);
+	}
+
+	std::vector<std::unique_ptr<Block>> blocks;
+	std::vector<uint32_t> freeBlocks;
+	uint32_t currentBlock = 0;
+	uint32_t currentOffset = 0;
+};
+
+// scores of a game in progress
+struct Standings
 {
 	// track score for each player
-	std::vector<int64_t> playerScores(playerCount, 0);
+	std::vector<int64_t> playerScores;
 
-	// start with the first player
+	// player to play the next marble
 	// (index is player number minus 1)
 	int currentPlayerIndex = 0;
 
 	// the (current) winning player
 	int winningPlayerIndex = -1;
 	int64_t winningPlayerScore = -1;
+};
 
-	// the circle of marbles;
-	// use a linked list instead of a vector because its insert and erase operations 
-	// are O(1) instead of O(N), making the overall game O(N) instead of O(N^2)
-	std::list<int> marbleCircle(1, 0);
-	std::list<int>::iterator currentMarble = marbleCircle.begin();
+// play the marbles from the first to the last
+template <typename Circle>
+void PlayMarbles(Standings &standings, Circle &marbleCircle, int firstMarbleWorth, int lastMarbleWorth)
+{
+	const int playerCount = int(standings.playerScores.size());
 
 	// for each marble to play...
-	for (int nextMarbleWorth = 1; nextMarbleWorth <= lastMarbleWorth; ++nextMarbleWorth)
+	for (int nextMarbleWorth = firstMarbleWorth; nextMarbleWorth <= lastMarbleWorth; ++nextMarbleWorth)
 	{
 		// if the marble's value is evenly divisible by 23...
 		if (nextMarbleWorth % 23 == 0)
 		{
-			int64_t &currentPlayerScore = playerScores[currentPlayerIndex];
+			int64_t &currentPlayerScore = standings.playerScores[standings.currentPlayerIndex];
 
 			// score the marble that would have been played
 			currentPlayerScore += nextMarbleWorth;
 
-			// get the  marble 7 places counter-clockwise from the current marble
-			// (and we have to do this because list iterators are not random access)
-			for (int i = 0; i < 7; ++i)
-			{
-				if (currentMarble == marbleCircle.begin())
-					currentMarble = marbleCircle.end();
-				--currentMarble;
-			}
-
-			// score the marble
-			currentPlayerScore += *currentMarble;
-
-			// remove it from the circle and make its clockwise neighbor current
-			currentMarble = marbleCircle.erase(currentMarble);
+			// remove the marble 7 places counter-clockwise from the current marble and score it
+			currentPlayerScore += marbleCircle.Remove();
 
 			// update the winning player
-			if (winningPlayerScore < currentPlayerScore)
+			if (standings.winningPlayerScore < currentPlayerScore)
 			{
-				winningPlayerScore = currentPlayerScore;
-				winningPlayerIndex = currentPlayerIndex;
+				standings.winningPlayerScore = currentPlayerScore;
+				standings.winningPlayerIndex = standings.currentPlayerIndex;
 			}
 		}
 		else
 		{
-			// insert the marble between the 1st and 2nd marble clockwise
-			// from the current marble and make it the new current marble
-			++currentMarble;
-			if (currentMarble == marbleCircle.end())
-				currentMarble = marbleCircle.begin();
-			++currentMarble;
-			currentMarble = marbleCircle.insert(currentMarble, nextMarbleWorth);
+			// insert the marble and make it the new current marble
+			marbleCircle.Insert(nextMarbleWorth);
 		}
 
 		// move to the next player
-		currentPlayerIndex = (currentPlayerIndex + 1) % playerCount;
+		standings.currentPlayerIndex = (standings.currentPlayerIndex + 1) % playerCount;
+	}
+}
+
+// play a game and find the winning player
+template <typename Circle>
+void Play(int &winningPlayerIndex, int64_t &winningPlayerScore, Circle &marbleCircle, int playerCount, int lastMarbleWorth)
+{
+	// start with the first player and no scores
+	Standings standings;
+	standings.playerScores.assign(playerCount, 0);
+
+	// start the circle of marbles
+	marbleCircle.Reset(lastMarbleWorth);
+
+	PlayMarbles(standings, marbleCircle, 1, lastMarbleWorth);
+
+	winningPlayerIndex = standings.winningPlayerIndex;
+	winningPlayerScore = standings.winningPlayerScore;
+}
+
+#ifdef CHECKPOINT
+// checkpoint file header
+struct CheckpointHeader
+{
+	char tag[4];
+	int32_t playerCount;
+	int32_t nextMarbleWorth;
+	int32_t currentPlayerIndex;
+	int32_t winningPlayerIndex;
+	int64_t winningPlayerScore;
+	uint64_t marbleCount;
+};
+
+const char CHECKPOINT_TAG[4] = { 'D', '9', 'C', 'K' };
+
+// save the state of a game to a binary checkpoint file
+bool SaveCheckpoint(char const *path, Standings const &standings, BlockMarbleCircle const &marbleCircle, int nextMarbleWorth)
+{
+	std::vector<uint32_t> marbles;
+	marbleCircle.Save(marbles);
+
+	// clear the padding as well as the fields so the file contents are deterministic
+	CheckpointHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.tag, CHECKPOINT_TAG, sizeof(header.tag));
+	header.playerCount = int32_t(standings.playerScores.size());
+	header.nextMarbleWorth = nextMarbleWorth;
+	header.currentPlayerIndex = standings.currentPlayerIndex;
+	header.winningPlayerIndex = standings.winningPlayerIndex;
+	header.winningPlayerScore = standings.winningPlayerScore;
+	header.marbleCount = marbles.size();
+
+	// write to a temporary file and then replace the old checkpoint
+	// so an interrupted save leaves the previous checkpoint intact
+	std::string temporaryPath = std::string(path) + ".tmp";
+	{
+		std::ofstream output(temporaryPath, std::ios::binary | std::ios::trunc);
+		output.write(reinterpret_cast<char const *>(&header), sizeof(header));
+		output.write(reinterpret_cast<char const *>(standings.playerScores.data()), standings.playerScores.size() * sizeof(int64_t));
+		output.write(reinterpret_cast<char const *>(marbles.data()), marbles.size() * sizeof(uint32_t));
+		if (!output)
+			return false;
 	}
+	remove(path);
+	return rename(temporaryPath.c_str(), path) == 0;
+}
+
+// restore the state of a game from a binary checkpoint file
+// (only if it belongs to a game with the same player count that has not gone past the last marble,
+// and its contents are consistent, so a corrupt or foreign file is ignored)
+bool LoadCheckpoint(char const *path, Standings &standings, BlockMarbleCircle &marbleCircle, int &nextMarbleWorth, int playerCount, int lastMarbleWorth)
+{
+	std::ifstream input(path, std::ios::binary);
+	CheckpointHeader header = {};
+	if (!input.read(reinterpret_cast<char *>(&header), sizeof(header)))
+		return false;
+	if (memcmp(header.tag, CHECKPOINT_TAG, sizeof(header.tag)) != 0 ||
+		header.playerCount != playerCount ||
+		header.nextMarbleWorth < 1 ||
+		header.nextMarbleWorth > lastMarbleWorth + 1)
+		return false;
+
+	// every marble played adds one to the circle, except each multiple of 23, which takes away another instead
+	const int64_t marblesPlayed = header.nextMarbleWorth - 1;
+	const uint64_t expectedMarbleCount = uint64_t(1 + marblesPlayed - 2 * (marblesPlayed / 23));
+	if (header.marbleCount != expectedMarbleCount)
+		return false;
+
+	// there is no winning player until the first marble is scored
+	if (header.currentPlayerIndex < 0 || header.currentPlayerIndex >= playerCount ||
+		header.winningPlayerIndex < -1 || header.winningPlayerIndex >= playerCount)
+		return false;
+
+	std::vector<int64_t> playerScores(playerCount);
+	std::vector<uint32_t> marbles(size_t(header.marbleCount));
+	input.read(reinterpret_cast<char *>(playerScores.data()), playerScores.size() * sizeof(int64_t));
+	input.read(reinterpret_cast<char *>(marbles.data()), marbles.size() * sizeof(uint32_t));
+	if (!input)
+		return false;
+
+	standings.playerScores.swap(playerScores);
+	standings.currentPlayerIndex = header.currentPlayerIndex;
+	standings.winningPlayerIndex = header.winningPlayerIndex;
+	standings.winningPlayerScore = header.winningPlayerScore;
+	marbleCircle.Load(marbles);
+	nextMarbleWorth = header.nextMarbleWorth;
+	return true;
+}
+
+// play a game in stages, reporting the leader and saving a checkpoint after each stage
+void PlayWithCheckpoints(int playerCount, int lastMarbleWorth, int interval, char const *path)
+{
+	Standings standings;
+	BlockMarbleCircle marbleCircle;
+	int nextMarbleWorth = 1;
+
+	if (LoadCheckpoint(path, standings, marbleCircle, nextMarbleWorth, playerCount, lastMarbleWorth))
+	{
+		std::cout << "resuming from checkpoint at marble " << nextMarbleWorth - 1 << "\n";
+	}
+	else
+	{
+		// start with the first player, no scores, and only the 0 marble
+		standings.playerScores.assign(playerCount, 0);
+		marbleCircle.Reset(lastMarbleWorth);
+	}
+
+	while (nextMarbleWorth <= lastMarbleWorth)
+	{
+		// play through the end of the current stage
+		int stageMarbleWorth = std::min(lastMarbleWorth, (nextMarbleWorth - 1) / interval * interval + interval);
+		PlayMarbles(standings, marbleCircle, nextMarbleWorth, stageMarbleWorth);
+		nextMarbleWorth = stageMarbleWorth + 1;
+
+		std::cout << "marble " << stageMarbleWorth << ": player " << standings.winningPlayerIndex + 1 << " leads with " << standings.winningPlayerScore << " points\n";
+
+		if (!SaveCheckpoint(path, standings, marbleCircle, nextMarbleWorth))
+			std::cout << "failed to save checkpoint " << path << "\n";
+	}
+
+	std::cout << "player " << standings.winningPlayerIndex + 1 << " wins with " << standings.winningPlayerScore << " points\n";
+}
+#endif
+
+void Part(int partNumber, int playerCount, int lastMarbleWorth)
+{
+	LinkedMarbleCircle marbleCircle;
+	int winningPlayerIndex;
+	int64_t winningPlayerScore;
+	Play(winningPlayerIndex, winningPlayerScore, marbleCircle, playerCount, lastMarbleWorth);
 
 	std::cout << "Part " << partNumber << ": player " << winningPlayerIndex + 1 << " wins with " << winningPlayerScore << " points\n";
 }
 
+#ifdef BENCHMARK
+// time a game with the given circle implementation
+template <typename Circle>
+void Benchmark(char const *name, Circle &marbleCircle, int playerCount, int lastMarbleWorth)
+{
+	int winningPlayerIndex;
+	int64_t winningPlayerScore;
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	Play(winningPlayerIndex, winningPlayerScore, marbleCircle, playerCount, lastMarbleWorth);
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+	double nanoseconds = std::chrono::duration<double, std::nano>(t2 - t1).count();
+	std::cout << name << " " << lastMarbleWorth << ": player " << winningPlayerIndex + 1 << " wins with " << winningPlayerScore << " points [" << nanoseconds / lastMarbleWorth << " ns/marble]\n";
+}
+#endif
+
+#ifdef BATCH
+// a game to play in a batch
+struct Game
+{
+	int playerCount;
+	int lastMarbleWorth;
+	int winningPlayerIndex;
+	int64_t winningPlayerScore;
+	float time;
+};
+
+// play all the games using a pool of worker threads
+void PlayBatch(std::vector<Game> &games)
+{
+	// hand out the longest games first so the last ones to finish are short
+	std::vector<size_t> order(games.size());
+	std::iota(order.begin(), order.end(), size_t(0));
+	std::sort(order.begin(), order.end(), [&games](size_t a, size_t b)
+	{
+		return games[a].lastMarbleWorth > games[b].lastMarbleWorth;
+	});
+
+	// each worker takes the next unclaimed game until none are left
+	// (games are independent, so a shared counter balances the load without per-worker queues)
+	std::atomic<size_t> nextGame(0);
+	auto worker = [&games, &order, &nextGame]()
+	{
+		// each worker reuses its circle storage from game to game
+		LinkedMarbleCircle marbleCircle;
+		for (size_t index = nextGame++; index < order.size(); index = nextGame++)
+		{
+			Game &game = games[order[index]];
+			std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+			Play(game.winningPlayerIndex, game.winningPlayerScore, marbleCircle, game.playerCount, game.lastMarbleWorth);
+			std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+			game.time = std::chrono::duration<float>(t2 - t1).count();
+		}
+	};
+
+	size_t threadCount = std::max(1U, std::thread::hardware_concurrency());
+	threadCount = std::min(threadCount, games.size());
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < threadCount; ++i)
+	{
+		threads.emplace_back(worker);
+	}
+	worker();
+	for (std::thread &thread : threads)
+	{
+		thread.join();
+	}
+}
+#endif
+
 int main()
 {
+#ifdef BATCH
+	// get the player count and what the last marble is worth for each game
+	std::vector<Game> games;
+	char line[256];
+	while (std::cin.getline(line, sizeof(line)))
+	{
+		Game game = {};
+		if (sscanf_s(line, "%d players; last marble is worth %d points", &game.playerCount, &game.lastMarbleWorth) == 2)
+			games.push_back(game);
+	}
+
+	PlayBatch(games);
+
+	// report results in input order
+	for (Game const &game : games)
+	{
+		std::cout << game.playerCount << " players; last marble is worth " << game.lastMarbleWorth << " points: player " << game.winningPlayerIndex + 1 << " wins with " << game.winningPlayerScore << " points [" << game.time << "]\n";
+	}
+#else
 	// get the player count and what the last marble is worth
 	int playerCount  = 0, lastMarbleWorth = 0;
 	char line[256];
 	std::cin.getline(line, sizeof(line));
 	sscanf_s(line, "%d players; last marble is worth %d points", &playerCount, &lastMarbleWorth);
 
+#if defined(CHECKPOINT)
+	PlayWithCheckpoints(playerCount, lastMarbleWorth * CHECKPOINT_SCALE, CHECKPOINT_INTERVAL, CHECKPOINT_PATH);
+#elif defined(BENCHMARK)
+	// the linked circle needs 8 bytes per marble value
+	// so only the block circle runs the largest games
+	const int scales[] = { 1, 10, 100, 1000 };
+	LinkedMarbleCircle linkedCircle;
+	BlockMarbleCircle blockCircle;
+	for (int scale : scales)
+	{
+		if (scale <= 100)
+			Benchmark("linked", linkedCircle, playerCount, lastMarbleWorth * scale);
+		Benchmark("block", blockCircle, playerCount, lastMarbleWorth * scale);
+		std::cout << "block memory " << blockCircle.MemoryUsed() / (1024 * 1024) << " MB\n";
+	}
+#else
 	Part(1, playerCount, lastMarbleWorth);
 	Part(2, playerCount, lastMarbleWorth * 100);
+#endif
+#endif
 
 	return 0;
 }
\ No newline at end of file